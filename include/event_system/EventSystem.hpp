@@ -1,18 +1,38 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <compare>
+#include <cstddef>
+#include <filesystem>
 #include <concepts>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <memory_resource>
 #include <mutex>
-#include <typeindex>
+#include <shared_mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <typeinfo>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "event_system/Executor.hpp"
+#include "event_system/internal/CapacityProfile.hpp"
+#include "event_system/internal/DenseDirectory.hpp"
 #include "event_system/internal/IDispatcher.hpp"
 #include "event_system/internal/Dispatcher.hpp"
+#include "event_system/internal/EventQueue.hpp"
+#include "event_system/internal/SignalRing.hpp"
+#include "event_system/internal/TypeId.hpp"
+#include "event_system/internal/WaitStrategy.hpp"
 
 namespace NEventSystem {
 
@@ -20,11 +40,66 @@ namespace NEventSystem {
     concept EventConstraint =
         std::is_class_v<T> && std::move_constructible<T>;
 
+    /// Обработчик события: вызывается с const TEvent&.
+    /// Внутри вызов идёт через thunk, который для маленьких trivially
+    /// copyable событий передаёт их по значению.
+    template <typename F, typename TEvent>
+    concept HandlerFor =
+        std::invocable<std::remove_cvref_t<F>&, const TEvent&>;
+
+    /// События, которые можно ставить в очередь из обработчика сигнала.
+    template <typename T>
+    concept SignalEventConstraint =
+        EventConstraint<T> && std::is_trivially_copyable_v<T>;
+
+    class TEventSystem;
+
+    /// Идентификатор строкового топика. Создаётся только TEventSystem::Intern,
+    /// поэтому вместо топика нельзя передать id типа события или число,
+    /// которое Intern не возвращал.
+    class TTopicId {
+    public:
+        constexpr NInternal::TTypeId Get() const noexcept {
+            return Value;
+        }
+
+        friend constexpr auto operator<=>(TTopicId, TTopicId) = default;
+
+    private:
+        friend class TEventSystem;
+
+        explicit constexpr TTopicId(NInternal::TTypeId value) noexcept
+            : Value(value) {
+        }
+
+        NInternal::TTypeId Value;
+    };
+
+    /// Событие строкового топика для плагинов и скриптов.
+    /// Payload — непрозрачные байты, валидные только на время вызова обработчика.
+    struct TTopicEvent {
+        TTopicId Topic;
+        std::span<const std::byte> Payload;
+    };
+
+    /// Что делать с событием, дедлайн которого прошёл до доставки.
+    enum class EExpiredPolicy {
+        Drop,    ///< Молча удалить.
+        Redirect ///< Доставить обработчикам TExpired<TEvent>.
+    };
+
+    /// Просроченное событие при EExpiredPolicy::Redirect.
+    template <typename TEvent>
+    struct TExpired {
+        TEvent Event;
+    };
+
     /// Основной класс системы событий.
     class TEventSystem {
     public:
         using HandlerId = NEventSystem::THandlerId;
         using Priority = NEventSystem::EPriority;
+        using PriorityValue = NEventSystem::TPriority;
 
         /// RAII-обёртка для автоматической отписки обработчика.
         class TScopedConnection {
@@ -75,41 +150,277 @@ namespace NEventSystem {
         };
 
         TEventSystem() = default;
+
+        /// Доставки, оставшиеся в очередях исполнителей, держат свой
+        /// диспетчер живым. Подписки таких диспетчеров снимаются, так что
+        /// после разрушения системы эти доставки только отбрасываются.
+        ~TEventSystem() {
+            for (const auto& Dispatcher : Dispatchers) {
+                if (Dispatcher && Dispatcher.use_count() > 1) {
+                    Dispatcher->Clear();
+                }
+            }
+        }
+
         TEventSystem(const TEventSystem&) = delete;
         TEventSystem& operator=(const TEventSystem&) = delete;
 
         /// Подписка обработчика.
+        /// Обработчик — любой вызываемый объект, принимающий const TEvent&.
+        template <EventConstraint TEvent, HandlerFor<TEvent> THandler>
+        HandlerId Subscribe(TPriority priority, THandler&& handler) {
+            return SubscribeImpl<TEvent>(priority, std::forward<THandler>(handler), false);
+        }
+
+        /// Подписка с меткой и ограничениями Before/After относительно
+        /// других обработчиков того же события. Порядок пересчитывается
+        /// при подписке; при цикле бросается std::logic_error с метками цикла.
+        template <EventConstraint TEvent, HandlerFor<TEvent> THandler>
+        HandlerId Subscribe(TPriority priority, TOrdering Ordering, THandler&& handler) {
+            return SubscribeImpl<TEvent>(priority, std::forward<THandler>(handler), false, nullptr,
+                                         std::make_shared<const TOrdering>(std::move(Ordering)));
+        }
+
+        template <EventConstraint TEvent, HandlerFor<TEvent> THandler>
+        HandlerId SubscribeOnce(TPriority priority, THandler&& handler) {
+            return SubscribeImpl<TEvent>(priority, std::forward<THandler>(handler), true);
+        }
+
+        /// Асинхронная подписка: обработчик вызывается потоком, который
+        /// разбирает Executor. При рассылке на несколько исполнителей событие
+        /// копируется один раз в общий неизменяемый блок.
+        template <EventConstraint TEvent, HandlerFor<TEvent> THandler>
+        HandlerId SubscribeOn(TExecutor& Executor,
+                              TPriority priority,
+                              THandler&& handler) {
+            return SubscribeImpl<TEvent>(priority, std::forward<THandler>(handler), false, &Executor.Queue);
+        }
+
+        /// Подписка стадии конвейера: получает событие по неконстантной
+        /// ссылке и выполняется до всех обычных обработчиков (в порядке
+        /// приоритета), поэтому может нормализовать событие на месте.
+        /// Без копии работает с Dispatch(TEvent&&); Dispatch(const TEvent&)
+        /// при наличии стадий копирует событие.
+        /// Стадия, подписанная во время Dispatch, начнёт работать со следующего события.
         template <EventConstraint TEvent>
-        HandlerId Subscribe(Priority priority,
-                            std::function<void(const TEvent&)> handler) {
-            return SubscribeImpl<TEvent>(priority, std::move(handler), false);
+        HandlerId SubscribeMutable(TPriority priority,
+                                   std::function<void(TEvent&)> handler) {
+            const HandlerId id =
+                NextId.fetch_add(1, std::memory_order_relaxed);
+
+            std::shared_lock Gate(SubscribeGate);
+            GetDispatcher<TEvent>().SubscribeStage(id, priority, std::move(handler), false);
+            RegisterHandler(id, NInternal::TypeIdOf<TEvent>());
+            return id;
         }
 
+        /// Подписка стока: не более одного на тип события, выполняется последним.
+        /// Если событие отправлено как rvalue (Dispatch(TEvent&&)), сток получает
+        /// его через move и может забрать буферы и строки без копирования;
+        /// иначе получает копию. Бросает std::logic_error, если сток уже есть.
         template <EventConstraint TEvent>
-        HandlerId SubscribeOnce(Priority priority,
-                                std::function<void(const TEvent&)> handler) {
-            return SubscribeImpl<TEvent>(priority, std::move(handler), true);
+        HandlerId SubscribeSink(std::function<void(TEvent&&)> handler) {
+            const HandlerId id =
+                NextId.fetch_add(1, std::memory_order_relaxed);
+
+            std::shared_lock Gate(SubscribeGate);
+            if (!GetDispatcher<TEvent>().SubscribeSink(id, std::move(handler))) {
+                throw std::logic_error("sink handler is already subscribed for this event type");
+            }
+            RegisterHandler(id, NInternal::TypeIdOf<TEvent>());
+            return id;
         }
 
         template <EventConstraint TEvent>
-        HandlerId SubscribeImpl(Priority priority,
-                                std::function<void(const TEvent&)> handler,
-                                bool OneShot) {
+        HandlerId SubscribeImpl(TPriority priority,
+                                typename NInternal::TDispatcher<TEvent>::Callback handler,
+                                bool OneShot,
+                                NInternal::TEventQueue* Executor = nullptr,
+                                std::shared_ptr<const TOrdering> Ordering = nullptr) {
             const HandlerId id =
                 NextId.fetch_add(1, std::memory_order_relaxed);
 
-            auto& dispatcher = GetDispatcher<TEvent>();
-            dispatcher.Subscribe(id, priority, std::move(handler), OneShot);
+            {
+                std::shared_lock Gate(SubscribeGate);
+                auto& dispatcher = GetDispatcher<TEvent>();
+                dispatcher.Subscribe(id, priority, std::move(handler), OneShot, Executor, std::move(Ordering));
+                RegisterHandler(id, NInternal::TypeIdOf<TEvent>());
+            }
+
+            NotifyCurrentDispatch(NInternal::TypeIdOf<TEvent>(), id);
+            return id;
+        }
+
+        /// Подписка с областью интереса: обработчик получает только события,
+        /// позиция которых (TPositionOf<TEvent>::Get) попадает в Region.
+        /// Подписчики лежат в равномерной сетке диспетчера, и событие
+        /// проверяет только подписчиков своей ячейки. Такие обработчики
+        /// вызываются в общем порядке приоритетов (при равном — после
+        /// обычных). SetPriority к таким подпискам не применяется; Pause,
+        /// Resume и Unsubscribe работают. Бросает std::invalid_argument,
+        /// если граница Region нечисловая или бесконечная.
+        template <EventConstraint TEvent, HandlerFor<TEvent> THandler>
+            requires PositionalEvent<TEvent>
+        HandlerId SubscribeInRegion(const TRegion& Region, TPriority priority, THandler&& handler) {
+            const HandlerId id = NextId.fetch_add(1, std::memory_order_relaxed);
+
+            std::shared_lock Gate(SubscribeGate);
+            GetDispatcher<TEvent>().SubscribeInRegion(id, priority, std::forward<THandler>(handler), Region);
+            RegisterHandler(id, NInternal::TypeIdOf<TEvent>());
+            return id;
+        }
+
+        /// Сменить область интереса (например, игрок переместился).
+        /// Меняются только ячейки, которые область покинула или заняла.
+        /// Возвращает false, если Id не подписан через SubscribeInRegion<TEvent>;
+        /// на нечисловую или бесконечную границу бросает std::invalid_argument.
+        template <PositionalEvent TEvent>
+        bool MoveRegion(HandlerId Id, const TRegion& Region) {
+            return GetDispatcher<TEvent>().MoveRegion(Id, Region);
+        }
+
+        /// Id строкового топика. Интернировать имя нужно один раз,
+        /// дальше подписка и доставка идут по плотному id без хеширования строк.
+        /// Топики не освобождаются и вместе с типами событий делят
+        /// NInternal::MaxDenseIds id на процесс; сверх предела бросается
+        /// std::length_error. Имя с переводом строки отвергается
+        /// std::invalid_argument.
+        static TTopicId Intern(std::string_view Name) {
+            return TTopicId(NInternal::InternTopic(Name));
+        }
+
+        /// Подписка на строковый топик. Обработчик получает const TTopicEvent&.
+        template <HandlerFor<TTopicEvent> THandler>
+        HandlerId Subscribe(TTopicId Topic, TPriority priority, THandler&& handler) {
+            const HandlerId id = NextId.fetch_add(1, std::memory_order_relaxed);
 
             {
-                std::lock_guard lock(Mutex);
-                HandlerTypes.emplace(id, std::type_index(typeid(TEvent)));
+                std::shared_lock Gate(SubscribeGate);
+                GetDispatcherById<TDispatcher<TTopicEvent>>(Topic.Get()).Subscribe(
+                    id, priority, std::forward<THandler>(handler), false);
+                RegisterHandler(id, Topic.Get());
             }
 
-            NotifyCurrentDispatch<TEvent>(id);
+            NotifyCurrentDispatch(Topic.Get(), id);
             return id;
         }
 
+        /// Предрегистрация типа: создать диспетчер и выделить место под
+        /// ExpectedHandlers подписок, чтобы первые Dispatch и Subscribe
+        /// в рабочем режиме не создавали диспетчер и не рехешировали реестр.
+        /// Ожидания Register, Reserve и LoadCapacityProfile складываются.
+        template <EventConstraint TEvent>
+        void Register(std::size_t ExpectedHandlers) {
+            GetDispatcher<TEvent>().Reserve(ExpectedHandlers);
+
+            std::lock_guard lock(Mutex);
+            ReserveHandlersUnlocked(ExpectedHandlers);
+        }
+
+        /// Выделить место во внутренних таблицах под ExpectedTypes новых
+        /// типов (топиков) и ExpectedHandlers подписок сверх уже
+        /// зарезервированных. Стек кадров Dispatch резервировать не нужно:
+        /// первые кадры каждого потока лежат во встроенном массиве.
+        void Reserve(std::size_t ExpectedTypes, std::size_t ExpectedHandlers) {
+            const std::size_t TypeCount = NInternal::NextTypeId.load(std::memory_order_relaxed) + ExpectedTypes;
+
+            std::lock_guard lock(Mutex);
+            Dispatchers.reserve(TypeCount);
+            Directory.Reserve(TypeCount);
+            ReserveHandlersUnlocked(ExpectedHandlers);
+        }
+
+        /// Сохранить профиль ёмкости: пиковое число обработчиков и глубину
+        /// очереди отложенной доставки по каждому типу и топику.
+        /// Бросает std::runtime_error, если файл не удалось записать.
+        void ExportCapacityProfile(const std::filesystem::path& Path) const {
+            NInternal::TCapacityProfile Profile;
+            {
+                std::lock_guard lock(Mutex);
+                for (std::size_t Type = 0; Type < Dispatchers.size(); ++Type) {
+                    if (!Dispatchers[Type]) {
+                        continue;
+                    }
+                    const auto Stats = Dispatchers[Type]->GetCapacityStats();
+                    Profile[DispatcherNames[Type]] = {Stats.PeakHandlers, Stats.PeakQueued};
+                }
+            }
+
+            const auto Peak = Queue.GetPeakDepth();
+            const std::array<std::size_t, 3> LanePeaks{Peak.High, Peak.Normal, Peak.Low};
+            for (std::size_t i = 0; i < LanePeaks.size(); ++i) {
+                Profile[NInternal::QueueLaneProfileNames[i]] = {0, LanePeaks[i]};
+            }
+
+            NInternal::WriteCapacityProfile(Path, Profile);
+        }
+
+        /// Загрузить профиль прошлого запуска и заранее выделить место:
+        /// уже созданные диспетчеры резервируются сразу, остальные — при
+        /// первом обращении к типу. Возвращает false, если профиля нет.
+        bool LoadCapacityProfile(const std::filesystem::path& Path) {
+            NInternal::TCapacityProfile Profile;
+            if (!NInternal::ReadCapacityProfile(Path, Profile)) {
+                return false;
+            }
+
+            // Индекс обработчиков общий на все типы — ему нужна сумма.
+            // Очереди — пики её полос; в старом профиле их нет, и тогда
+            // берётся наибольший пик одного типа (сумма пиков, которые
+            // случились в разное время, завышает нужное).
+            std::size_t TotalHandlers = 0;
+            std::size_t MaxQueued = 0;
+            for (const auto& [_, Hint] : Profile) {
+                TotalHandlers += Hint.Handlers;
+                MaxQueued = std::max(MaxQueued, Hint.Queued);
+            }
+
+            TQueueLaneSizes QueueCapacity{0, MaxQueued, 0};
+            if (Profile.contains(NInternal::QueueLaneProfileNames[0])) {
+                auto LanePeak = [&Profile](std::size_t Lane) {
+                    auto it = Profile.find(NInternal::QueueLaneProfileNames[Lane]);
+                    return it == Profile.end() ? std::size_t{0} : it->second.Queued;
+                };
+                QueueCapacity = {LanePeak(0), LanePeak(1), LanePeak(2)};
+            }
+
+            {
+                std::lock_guard lock(Mutex);
+                CapacityHints = std::move(Profile);
+                ReserveHandlersUnlocked(TotalHandlers);
+                for (std::size_t Type = 0; Type < Dispatchers.size(); ++Type) {
+                    if (Dispatchers[Type]) {
+                        ApplyCapacityHintUnlocked(Type);
+                    }
+                }
+            }
+
+            Queue.Reserve(QueueCapacity);
+            return true;
+        }
+
+        /// Снять все подписки всех типов, например при выгрузке уровня.
+        /// Диспетчеры, очередь и зарезервированная память остаются, так что
+        /// следующие подписки переиспользуют пулы. Вызывать, когда нет
+        /// идущих Dispatch; события в очередях не трогаются. Подписка,
+        /// идущая параллельно, целиком попадает либо до Clear (и снимается),
+        /// либо после (и остаётся).
+        void Clear() {
+            std::unique_lock Gate(SubscribeGate);
+            std::vector<std::shared_ptr<NInternal::TIDispatcher>> Current;
+            {
+                std::lock_guard lock(Mutex);
+                Current = Dispatchers;
+                HandlerTypes.clear();
+            }
+
+            for (const auto& Dispatcher : Current) {
+                if (Dispatcher) {
+                    Dispatcher->Clear();
+                }
+            }
+        }
+
         /// Отписка обработчика (как в ТЗ): с указанием типа события.
         template <EventConstraint TEvent>
         void Unsubscribe(HandlerId Id) {
@@ -121,6 +432,38 @@ namespace NEventSystem {
             UnsubscribeImpl(Id);
         }
 
+        /// Приостановить обработчик: он остаётся подписанным, сохраняет Id
+        /// и место в порядке вызова, но пропускается до Resume.
+        /// Возвращает false, если обработчик не найден.
+        bool Pause(HandlerId Id) {
+            const auto base = FindHandlerDispatcher(Id);
+            return base && base->SetPaused(Id, true);
+        }
+
+        bool Resume(HandlerId Id) {
+            const auto base = FindHandlerDispatcher(Id);
+            return base && base->SetPaused(Id, false);
+        }
+
+        /// Горячая замена обработчика: Id, приоритет, пауза и место в порядке
+        /// вызова сохраняются. Параллельный Dispatch вызывает либо старый,
+        /// либо новый обработчик и не пропускает его. Прошлая замена
+        /// освобождается после последнего такого Dispatch; обработчик,
+        /// переданный при подписке, хранится до отписки.
+        /// Возвращает false, если Id не найден, подписан на другой тип
+        /// или это стадия конвейера либо сток.
+        template <EventConstraint TEvent, HandlerFor<TEvent> THandler>
+        bool Replace(HandlerId Id, THandler&& handler) {
+            auto* Dispatcher = dynamic_cast<TDispatcher<TEvent>*>(FindHandlerDispatcher(Id).get());
+            return Dispatcher && Dispatcher->Replace(Id, std::forward<THandler>(handler));
+        }
+
+        /// Сменить приоритет подписки без переподписки.
+        bool SetPriority(HandlerId Id, TPriority priority) {
+            const auto base = FindHandlerDispatcher(Id);
+            return base && base->SetPriority(Id, priority);
+        }
+
         /// Диспетчеризация события.
         template <EventConstraint TEvent>
         void Dispatch(const TEvent& Event) {
@@ -132,79 +475,466 @@ namespace NEventSystem {
             Dispatcher.Dispatch(Event);
         }
 
+        /// Диспетчеризация события, которым система владеет на время вызова:
+        /// стадии конвейера меняют его на месте без лишней копии.
+        template <EventConstraint TEvent>
+            requires(!std::is_const_v<TEvent>)
+        void Dispatch(TEvent&& Event) {
+            auto& Dispatcher = GetDispatcher<TEvent>();
+
+            TDispatchFrame<TEvent> Frame(this, &Dispatcher, &Event);
+            TDispatchFrameGuard Guard(&Frame);
+
+            Dispatcher.Dispatch(Event);
+        }
+
+        /// Ленивая диспетчеризация: Factory() вызывается и результат
+        /// доставляется, только если у типа есть хоть один активный
+        /// обработчик не на паузе. Проверка — чтение без блокировок,
+        /// сама доставка идёт как обычный Dispatch собственного события.
+        /// Возвращает true, если событие было построено.
+        template <EventConstraint TEvent, typename TFactory>
+            requires std::is_invocable_r_v<TEvent, TFactory&>
+        bool DispatchLazy(TFactory&& Factory) {
+            const auto* Existing = static_cast<const TDispatcher<TEvent>*>(
+                Directory.Find(NInternal::TypeIdOf<TEvent>()));
+            if (!Existing || !Existing->IsListening()) {
+                return false;
+            }
+
+            Dispatch(TEvent(Factory()));
+            return true;
+        }
+
+        /// Доставка в строковый топик. Payload не копируется.
+        void Dispatch(TTopicId Topic, std::span<const std::byte> Payload) {
+            auto& Dispatcher = GetDispatcherById<TDispatcher<TTopicEvent>>(Topic.Get());
+            const TTopicEvent Event{Topic, Payload};
+
+            TDispatchFrame<TTopicEvent> Frame(this, &Dispatcher, &Event, Topic.Get());
+            TDispatchFrameGuard Guard(&Frame);
+
+            Dispatcher.Dispatch(Event);
+        }
+
+        /// Пакетная диспетчеризация: список обработчиков снимается один раз
+        /// на весь пакет, события доставляются по порядку.
+        template <EventConstraint TEvent>
+        void DispatchBatch(std::span<const TEvent> Events) {
+            if (Events.empty()) {
+                return;
+            }
+
+            auto& Dispatcher = GetDispatcher<TEvent>();
+            const auto Snapshot = Dispatcher.TakeSnapshot();
+
+            TDispatchFrame<TEvent> Frame(this, &Dispatcher, Events.data());
+            TDispatchFrameGuard Guard(&Frame);
+
+            for (const auto& Event : Events) {
+                Frame.Event = &Event;
+                Dispatcher.DispatchSnapshot(Snapshot, Event);
+            }
+        }
+
+        /// Поставить событие в очередь отложенной доставки.
+        /// Обработчики будут вызваны из DrainReady.
+        template <typename TEvent>
+            requires EventConstraint<std::remove_cvref_t<TEvent>>
+        void Enqueue(TEvent&& Event) {
+            Enqueue(Priority::Normal, std::forward<TEvent>(Event));
+        }
+
+        /// Поставить событие в полосу очереди по приоритету: при выборке
+        /// High-события любого типа идут раньше ожидающих Normal и Low,
+        /// а те получают долю по весам (SetQueueWeights) и не голодают.
+        template <typename TEvent>
+            requires EventConstraint<std::remove_cvref_t<TEvent>>
+        void Enqueue(TPriority priority, TEvent&& Event) {
+            using TDecayed = std::remove_cvref_t<TEvent>;
+
+            auto Payload = std::make_unique<TDecayed>(std::forward<TEvent>(Event));
+            PushQueued<TDecayed>({Payload.get(), this, &RunQueued<TDecayed>, &DropQueued<TDecayed>,
+                                  NInternal::TypeIdOf<TDecayed>(), &RunQueuedBatch<TDecayed>,
+                                  NInternal::QueueLaneOf(priority.Get())});
+            Payload.release();
+        }
+
+        /// Поставить событие в очередь с дедлайном. Такие события получают
+        /// свою долю взвешенного цикла очереди (TQueueWeights::Deadline)
+        /// первыми и внутри неё идут в порядке ближайшего дедлайна (EDF).
+        /// Если к выборке в DrainReady дедлайн прошёл, событие не доставляется:
+        /// оно удаляется или, при EExpiredPolicy::Redirect, уходит
+        /// обработчикам TExpired<TEvent>.
+        template <typename TEvent>
+            requires EventConstraint<std::remove_cvref_t<TEvent>>
+        void EnqueueWithDeadline(TEvent&& Event,
+                                 std::chrono::steady_clock::time_point Deadline,
+                                 EExpiredPolicy Policy = EExpiredPolicy::Drop) {
+            using TDecayed = std::remove_cvref_t<TEvent>;
+
+            auto Payload = std::make_unique<TDecayed>(std::forward<TEvent>(Event));
+            NInternal::TQueuedItem Item{Payload.get(), this, &RunQueued<TDecayed>, &DropQueued<TDecayed>,
+                                        NInternal::TypeIdOf<TDecayed>(), &RunQueuedBatch<TDecayed>};
+            Item.Deadline = Deadline;
+            Item.Expire = Policy == EExpiredPolicy::Redirect ? &RedirectExpired<TDecayed> : &DropExpired<TDecayed>;
+            PushQueued<TDecayed>(Item);
+            Payload.release();
+        }
+
+        /// Доставить не более MaxBatch событий из очереди.
+        /// Возвращает количество доставленных событий.
+        /// В режиме EDrainOrder::GroupByType события одного типа доставляются
+        /// подряд по одному снимку обработчиков; порядок между типами не сохраняется.
+        /// Сначала разбираются сигнальные очереди (TrySignalEnqueue): они
+        /// ограничены своей ёмкостью, в MaxBatch не входят, но попадают в счёт.
+        std::size_t DrainReady(std::size_t MaxBatch = std::numeric_limits<std::size_t>::max(),
+                               EDrainOrder Order = EDrainOrder::Fifo) {
+            const std::size_t Signals = DrainSignalQueues();
+            return Signals + Queue.DrainReady(MaxBatch, Order);
+        }
+
+        /// Разбор очереди с бюджетом времени на кадр: события идут в том же
+        /// порядке, что в DrainReady, пока предсказанная по скользящему
+        /// среднему своего типа стоимость следующего укладывается в остаток
+        /// бюджета. В отчёте — сколько обработано и сколько осталось.
+        /// Сигнальные очереди, как и в DrainReady, разбираются первыми.
+        TBudgetReport ProcessQueueFor(std::chrono::microseconds Budget) {
+            const std::size_t Signals = DrainSignalQueues();
+            auto Report = Queue.DrainFor(Budget);
+            Report.Processed += Signals;
+            return Report;
+        }
+
+        /// Блокирующая доставка для потребителя без epoll: ждать событий
+        /// в очереди или сигнальных очередях по текущей стратегии ожидания,
+        /// затем доставить их. Возвращает 0, если ожидание прервано InterruptWait.
+        std::size_t WaitAndDrain(std::size_t MaxBatch = std::numeric_limits<std::size_t>::max()) {
+            for (;;) {
+                const auto Observed = Queue.WaitEpoch();
+                const std::size_t Delivered = DrainReady(MaxBatch);
+                if (Delivered != 0) {
+                    return Delivered;
+                }
+                if (Queue.ConsumeInterrupt()) {
+                    return 0;
+                }
+                Queue.WaitFor(Observed);
+            }
+        }
+
+        /// Прервать ожидание одного потребителя в WaitAndDrain.
+        void InterruptWait() {
+            Queue.Interrupt();
+        }
+
+        /// Стратегия ожидания для WaitAndDrain.
+        void SetWaitStrategy(EWaitStrategy Strategy) {
+            Queue.SetWaitStrategy(Strategy);
+        }
+
+        /// Веса полос приоритета очереди. Бросает std::invalid_argument
+        /// на нулевой вес.
+        void SetQueueWeights(const TQueueWeights& Weights) {
+            Queue.SetWeights(Weights);
+        }
+
+        /// eventfd, который становится читаемым, когда в очереди появились
+        /// события. Предназначен для регистрации в epoll (-1 вне Linux).
+        int GetQueueFd() const {
+            return Queue.GetWakeupFd();
+        }
+
+        /// Количество событий, ожидающих в очереди.
+        std::size_t GetQueueSize() const {
+            return Queue.Size();
+        }
+
+        /// Сколько событий каждая полоса очереди примет без перевыделения.
+        TQueueLaneSizes GetQueueCapacity() const {
+            return Queue.GetCapacity();
+        }
+
+        /// Заранее выделить очередь на Capacity событий для TrySignalEnqueue<TEvent>.
+        /// Вызывается из обычного потока до установки обработчика сигнала.
+        template <SignalEventConstraint TEvent>
+        void ReserveSignalQueue(std::size_t Capacity) {
+            std::lock_guard lock(Mutex);
+            if (FindSignalQueue<TEvent>()) {
+                return;
+            }
+
+            auto SignalQueue = std::make_unique<TSignalQueue<TEvent>>(*this, Capacity);
+            SignalQueue->Next = SignalQueues.load(std::memory_order_relaxed);
+            SignalQueues.store(SignalQueue.get(), std::memory_order_release);
+            SignalQueueStorage.push_back(std::move(SignalQueue));
+        }
+
+        /// Async-signal-safe постановка события: без аллокаций и блокировок.
+        /// Первое событие после разбора сигнальных очередей делает eventfd
+        /// (GetQueueFd) читаемым одной записью; если потребители ждут
+        /// в WaitAndDrain, может выполнить futex wake.
+        /// Возвращает false, если очередь для TEvent не зарезервирована
+        /// или заполнена.
+        template <SignalEventConstraint TEvent>
+        bool TrySignalEnqueue(const TEvent& Event) noexcept {
+            auto* SignalQueue = FindSignalQueue<TEvent>();
+            if (!SignalQueue || !SignalQueue->Ring.TryPush(Event)) {
+                return false;
+            }
+            Queue.NotifyWaitersFromSignal();
+            return true;
+        }
+
+        /// Доставить через Dispatch события, накопленные TrySignalEnqueue.
+        /// Вызывается из обычного потока; DrainReady, ProcessQueueFor
+        /// и WaitAndDrain вызывают его сами.
+        std::size_t DrainSignalQueues() {
+            // Отметка снимается до обхода: событие, поставленное после неё,
+            // взведёт eventfd заново.
+            if (!Queue.ConsumeSignalSources()) {
+                return 0;
+            }
+
+            std::size_t Delivered = 0;
+            try {
+                for (auto* SignalQueue = SignalQueues.load(std::memory_order_acquire); SignalQueue; SignalQueue = SignalQueue->Next) {
+                    Delivered += SignalQueue->Drain();
+                }
+            } catch (...) {
+                // Обработчик бросил: остаток очередей ждёт следующего разбора.
+                Queue.NotifyWaitersFromSignal();
+                throw;
+            }
+            return Delivered;
+        }
+
         /// Количество активных обработчиков для заданного типа события.
         template <typename TEvent>
         std::size_t GetHandlerCount() const {
-            const auto type = std::type_index(typeid(TEvent));
+            return CountById(NInternal::TypeIdOf<TEvent>());
+        }
+
+        /// Количество активных обработчиков строкового топика.
+        std::size_t GetHandlerCount(TTopicId Topic) const {
+            return CountById(Topic.Get());
+        }
+
+        /// Сколько обработчиков TEvent поместится без перевыделения списка
+        /// (0, если диспетчер типа ещё не создан).
+        template <typename TEvent>
+        std::size_t GetHandlerCapacity() const {
+            const auto* Existing = Directory.Find(NInternal::TypeIdOf<TEvent>());
+            return Existing ? Existing->GetCapacityStats().HandlerCapacity : 0;
+        }
 
+    private:
+        std::size_t CountById(NInternal::TTypeId Type) const {
             std::shared_ptr<NInternal::TIDispatcher> base;
             {
                 std::lock_guard lock(Mutex);
-                auto it = Dispatchers.find(type);
-                if (it == Dispatchers.end()) {
+                if (Type >= Dispatchers.size() || !Dispatchers[Type]) {
                     return 0;
                 }
-                base = it->second;
+                base = Dispatchers[Type];
             }
 
             return base->Count();
         }
 
-    private:
-        void UnsubscribeImpl(HandlerId id) {
-            std::type_index type(typeid(void));
+        std::shared_ptr<NInternal::TIDispatcher> FindHandlerDispatcher(HandlerId id) const {
+            std::lock_guard lock(Mutex);
+            auto it = HandlerTypes.find(id);
+            if (it == HandlerTypes.end() || it->second >= Dispatchers.size()) {
+                return nullptr;
+            }
+            return Dispatchers[it->second];
+        }
 
+        /// Индекс обработчиков резервируется под сумму всех ожиданий,
+        /// а не под последнее из них.
+        void ReserveHandlersUnlocked(std::size_t ExpectedHandlers) {
+            ReservedHandlers += ExpectedHandlers;
+            HandlerTypes.reserve(std::max(ReservedHandlers, HandlerTypes.size()));
+        }
+
+        void RegisterHandler(HandlerId id, NInternal::TTypeId Type) {
+            std::lock_guard lock(Mutex);
+            HandlerTypes.emplace(id, Type);
+        }
+
+        void UnsubscribeImpl(HandlerId id) {
+            std::shared_ptr<NInternal::TIDispatcher> base;
             {
                 std::lock_guard lock(Mutex);
                 auto it = HandlerTypes.find(id);
                 if (it == HandlerTypes.end()) {
                     return;
                 }
-                type = it->second;
+                if (it->second < Dispatchers.size()) {
+                    base = Dispatchers[it->second];
+                }
                 HandlerTypes.erase(it);
             }
 
-            std::shared_ptr<NInternal::TIDispatcher> base;
-            {
-                std::lock_guard lock(Mutex);
-                auto dit = Dispatchers.find(type);
-                if (dit == Dispatchers.end()) {
-                    return;
-                }
-                base = dit->second;
+            if (base) {
+                base->Remove(id);
+            }
+        }
+
+        /// Событие учитывается в глубине очереди своего типа до Push:
+        /// иначе потребитель может вычесть его раньше, чем оно учтено.
+        template <typename EventType>
+        void PushQueued(const NInternal::TQueuedItem& Item) {
+            auto& Dispatcher = GetDispatcher<EventType>();
+            Dispatcher.NoteQueued();
+            try {
+                Queue.Push(Item);
+            } catch (...) {
+                Dispatcher.NoteDequeued();
+                throw;
+            }
+        }
+
+        template <typename EventType>
+        static void RunQueued(void* Payload, void* Context) {
+            std::unique_ptr<EventType> Event(static_cast<EventType*>(Payload));
+            auto* Sys = static_cast<TEventSystem*>(Context);
+            Sys->GetDispatcher<EventType>().NoteDequeued();
+            Sys->Dispatch(std::move(*Event));
+        }
+
+        /// Групповая доставка из очереди: один снимок обработчиков на группу.
+        template <typename EventType>
+        static void RunQueuedBatch(const NInternal::TQueuedItem* Items, std::size_t Count, std::size_t& Done) {
+            auto* Sys = static_cast<TEventSystem*>(Items[0].Context);
+            auto& Dispatcher = Sys->GetDispatcher<EventType>();
+            const auto Snapshot = Dispatcher.TakeSnapshot();
+
+            TDispatchFrame<EventType> Frame(Sys, &Dispatcher, static_cast<const EventType*>(Items[0].Payload));
+            TDispatchFrameGuard Guard(&Frame);
+
+            while (Done < Count) {
+                std::unique_ptr<EventType> Event(static_cast<EventType*>(Items[Done++].Payload));
+                Dispatcher.NoteDequeued();
+                Frame.Event = Event.get();
+                Dispatcher.DispatchSnapshot(Snapshot, *Event);
             }
+        }
+
+        template <typename EventType>
+        static void DropQueued(void* Payload, void*) {
+            delete static_cast<EventType*>(Payload);
+        }
 
-            base->Remove(id);
+        template <typename EventType>
+        static void DropExpired(void* Payload, void* Context) {
+            std::unique_ptr<EventType> Event(static_cast<EventType*>(Payload));
+            static_cast<TEventSystem*>(Context)->GetDispatcher<EventType>().NoteDequeued();
+        }
+
+        template <typename EventType>
+        static void RedirectExpired(void* Payload, void* Context) {
+            std::unique_ptr<EventType> Event(static_cast<EventType*>(Payload));
+            auto* Sys = static_cast<TEventSystem*>(Context);
+            Sys->GetDispatcher<EventType>().NoteDequeued();
+            Sys->Dispatch(TExpired<EventType>{std::move(*Event)});
         }
 
         template <typename EventType>
         using TDispatcher = NInternal::TDispatcher<EventType>;
 
+        template <typename EventType>
+        struct TSignalQueue: NInternal::TSignalQueueBase {
+            TEventSystem* System;
+            NInternal::TSignalRing<EventType> Ring;
+
+            TSignalQueue(TEventSystem& Sys, std::size_t Capacity)
+                : TSignalQueueBase(NInternal::TypeIdOf<EventType>())
+                , System(&Sys)
+                , Ring(Capacity) {
+            }
+
+            std::size_t Drain() override {
+                std::size_t Delivered = 0;
+                while (auto Event = Ring.TryPop()) {
+                    System->Dispatch(*Event);
+                    ++Delivered;
+                }
+                return Delivered;
+            }
+        };
+
+        template <typename EventType>
+        TSignalQueue<EventType>* FindSignalQueue() const noexcept {
+            const auto Type = NInternal::TypeIdOf<EventType>();
+            for (auto* SignalQueue = SignalQueues.load(std::memory_order_acquire); SignalQueue; SignalQueue = SignalQueue->Next) {
+                if (SignalQueue->TypeId == Type) {
+                    return static_cast<TSignalQueue<EventType>*>(SignalQueue);
+                }
+            }
+            return nullptr;
+        }
+
         template <typename EventType>
         TDispatcher<EventType>& GetDispatcher() {
-            const auto type = std::type_index(typeid(EventType));
+            return GetDispatcherById<TDispatcher<EventType>>(NInternal::TypeIdOf<EventType>());
+        }
+
+        /// Диспетчер по плотному id типа или топика; создаётся при первом обращении.
+        template <typename TConcrete>
+        TConcrete& GetDispatcherById(NInternal::TTypeId Type) {
+            if (auto* Existing = Directory.Find(Type)) {
+                return *static_cast<TConcrete*>(Existing);
+            }
 
             std::lock_guard lock(Mutex);
+            // Место в каталоге — до создания диспетчера: если id вне
+            // диапазона, исключение не оставит полусозданной записи.
+            Directory.Prepare(Type);
 
-            auto it = Dispatchers.find(type);
-            if (it != Dispatchers.end()) {
-                return *static_cast<TDispatcher<EventType>*>(it->second.get());
+            if (Type >= Dispatchers.size()) {
+                Dispatchers.resize(static_cast<std::size_t>(Type) + 1);
             }
 
-            auto concrete = std::make_shared<TDispatcher<EventType>>();
-            Dispatchers.emplace(type, concrete);
-            return *concrete;
+            auto& slot = Dispatchers[Type];
+            if (!slot) {
+                slot = std::make_shared<TConcrete>();
+                if (DispatcherNames.size() <= Type) {
+                    DispatcherNames.resize(static_cast<std::size_t>(Type) + 1);
+                }
+                DispatcherNames[Type] = DispatcherName<typename TConcrete::EventType>(Type);
+                ApplyCapacityHintUnlocked(Type);
+                Directory.Publish(Type, slot.get());
+            }
+            return *static_cast<TConcrete*>(slot.get());
+        }
+
+        /// Устойчивое между запусками имя диспетчера для профиля ёмкости.
+        template <typename EventType>
+        static std::string DispatcherName(NInternal::TTypeId Type) {
+            if (const auto Topic = NInternal::TTopicRegistry::Instance().Name(Type); !Topic.empty()) {
+                return "topic:" + std::string(Topic);
+            }
+            return std::string("type:") + typeid(EventType).name();
+        }
+
+        void ApplyCapacityHintUnlocked(std::size_t Type) {
+            auto it = CapacityHints.find(DispatcherNames[Type]);
+            if (it != CapacityHints.end()) {
+                Dispatchers[Type]->Reserve(it->second.Handlers);
+            }
         }
 
         // --------- Стек контекстов диспетчеризации (thread_local) ---------
 
         struct TDispatchFrameBase {
             const TEventSystem* System;
-            std::type_index EventTypeIndex;
+            NInternal::TTypeId Type;
 
-            TDispatchFrameBase(const TEventSystem* Sys, std::type_index Type)
+            TDispatchFrameBase(const TEventSystem* Sys, NInternal::TTypeId EventType)
                 : System(Sys)
-                , EventTypeIndex(Type) {
+                , Type(EventType) {
             }
             virtual ~TDispatchFrameBase() = default;
             virtual void InvokeNewHandler(THandlerId Id) = 0;
@@ -217,8 +947,9 @@ namespace NEventSystem {
 
             TDispatchFrame(const TEventSystem* Sys,
                            TDispatcher<EventType>* Disp,
-                           const EventType* Ev)
-                : TDispatchFrameBase(Sys, std::type_index(typeid(EventType)))
+                           const EventType* Ev,
+                           NInternal::TTypeId Type = NInternal::TypeIdOf<EventType>())
+                : TDispatchFrameBase(Sys, Type)
                 , Dispatcher(Disp)
                 , Event(Ev) {
             }
@@ -247,31 +978,50 @@ namespace NEventSystem {
             TDispatchFrameBase* Frame;
         };
 
-        inline static thread_local std::vector<TDispatchFrameBase*>
-            DispatchStack;
+        /// Стек кадров потока. Первые InlineFrames кадров лежат во встроенном
+        /// массиве, так что первый Dispatch в любом потоке не аллоцирует;
+        /// куча нужна только при вложенности глубже InlineFrames.
+        struct TFrameStack {
+            static constexpr std::size_t InlineFrames = 16;
+
+            std::array<TDispatchFrameBase*, InlineFrames> Inline;
+            std::vector<TDispatchFrameBase*> Overflow;
+            std::size_t Size;
+
+            TFrameStack() noexcept
+                : Inline{}
+                , Size(0) {
+            }
+
+            TDispatchFrameBase* operator[](std::size_t Index) const noexcept {
+                return Index < InlineFrames ? Inline[Index] : Overflow[Index - InlineFrames];
+            }
+        };
+
+        inline static thread_local TFrameStack DispatchStack;
 
         static void PushFrame(TDispatchFrameBase* frame) {
-            DispatchStack.push_back(frame);
+            if (DispatchStack.Size < TFrameStack::InlineFrames) {
+                DispatchStack.Inline[DispatchStack.Size] = frame;
+            } else {
+                DispatchStack.Overflow.push_back(frame);
+            }
+            ++DispatchStack.Size;
         }
 
         static void PopFrame() {
-            DispatchStack.pop_back();
+            if (--DispatchStack.Size >= TFrameStack::InlineFrames) {
+                DispatchStack.Overflow.pop_back();
+            }
         }
 
-        /// Если в текущем потоке идёт dispatch того же TEvent для
+        /// Если в текущем потоке идёт dispatch того же типа (топика) для
         /// этого же EventSystem, вызываем только что подписанный обработчик
         /// на "текущем" событии.
-        template <typename EventType>
-        void NotifyCurrentDispatch(THandlerId Id) {
-            if (DispatchStack.empty()) {
-                return;
-            }
-
-            const std::type_index Type(typeid(EventType));
-
-            for (auto it = DispatchStack.rbegin(); it != DispatchStack.rend(); ++it) {
-                auto* Frame = *it;
-                if (Frame->System == this && Frame->EventTypeIndex == Type) {
+        void NotifyCurrentDispatch(NInternal::TTypeId Type, THandlerId Id) {
+            for (std::size_t i = DispatchStack.Size; i-- > 0;) {
+                auto* Frame = DispatchStack[i];
+                if (Frame->System == this && Frame->Type == Type) {
                     Frame->InvokeNewHandler(Id);
                     break;
                 }
@@ -281,14 +1031,34 @@ namespace NEventSystem {
         // --------- Данные ---------
 
         mutable std::mutex Mutex;
+        /// Подписка держит разделяемо от вставки в диспетчер до записи
+        /// в HandlerTypes, Clear — исключительно: иначе Clear мог бы
+        /// попасть между шагами и оставить id без обработчика или
+        /// обработчик без id. Берётся раньше Mutex.
+        std::shared_mutex SubscribeGate;
 
-        std::unordered_map<std::type_index,
-                           std::shared_ptr<NInternal::TIDispatcher>>
-            Dispatchers;
+        /// Диспетчеры, индексированные плотным id типа события или топика.
+        std::vector<std::shared_ptr<NInternal::TIDispatcher>> Dispatchers;
+        /// Те же диспетчеры для поиска без блокировки на горячем пути.
+        NInternal::TDenseDirectory<NInternal::TIDispatcher> Directory;
+        std::vector<std::string> DispatcherNames;
+        /// Профиль ёмкости прошлого запуска (LoadCapacityProfile).
+        NInternal::TCapacityProfile CapacityHints;
 
-        std::unordered_map<HandlerId, std::type_index> HandlerTypes;
+        /// Узлы индекса обработчиков берутся из пула, а не из кучи по одному:
+        /// при Clear() они возвращаются в пул, при разрушении системы пул
+        /// отдаёт память блоками. Доступ только под Mutex.
+        std::pmr::unsynchronized_pool_resource HandlerPool;
+        std::pmr::unordered_map<HandlerId, NInternal::TTypeId> HandlerTypes{&HandlerPool};
+        /// Сумма ожиданий Register, Reserve и профиля ёмкости.
+        std::size_t ReservedHandlers = 0;
 
         std::atomic<HandlerId> NextId{1};
+
+        NInternal::TEventQueue Queue;
+
+        std::atomic<NInternal::TSignalQueueBase*> SignalQueues{nullptr};
+        std::vector<std::unique_ptr<NInternal::TSignalQueueBase>> SignalQueueStorage;
     };
 
 } // namespace NEventSystem
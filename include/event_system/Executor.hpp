@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+#include "event_system/internal/EventQueue.hpp"
+#include "event_system/internal/WaitStrategy.hpp"
+
+namespace NEventSystem {
+
+    class TEventSystem;
+
+    /// Исполнитель асинхронных обработчиков.
+    /// Обработчики, подписанные через TEventSystem::SubscribeOn, вызываются
+    /// не в потоке Dispatch, а тем потоком, который разбирает исполнитель
+    /// (DrainReady / WaitAndDrain или epoll по GetWakeupFd).
+    ///
+    /// Исполнитель должен жить дольше подписанных на него обработчиков.
+    /// Исполнитель может пережить TEventSystem: доставки, оставшиеся
+    /// в очереди, держат свой диспетчер и при разборе отбрасываются, не
+    /// вызывая обработчиков. Разбирать очередь одновременно с разрушением
+    /// TEventSystem нельзя.
+    class TExecutor {
+    public:
+        TExecutor() = default;
+        TExecutor(const TExecutor&) = delete;
+        TExecutor& operator=(const TExecutor&) = delete;
+
+        /// Выполнить не более MaxBatch отложенных доставок.
+        /// EDrainOrder::GroupByType собирает доставки одного типа события подряд.
+        std::size_t DrainReady(std::size_t MaxBatch = std::numeric_limits<std::size_t>::max(),
+                               EDrainOrder Order = EDrainOrder::Fifo) {
+            return Queue.DrainReady(MaxBatch, Order);
+        }
+
+        /// Ждать доставок по текущей стратегии и выполнить их.
+        /// Возвращает 0, если ожидание прервано Interrupt.
+        std::size_t WaitAndDrain(std::size_t MaxBatch = std::numeric_limits<std::size_t>::max()) {
+            return Queue.WaitAndDrain(MaxBatch);
+        }
+
+        void Interrupt() {
+            Queue.Interrupt();
+        }
+
+        void SetWaitStrategy(EWaitStrategy Strategy) {
+            Queue.SetWaitStrategy(Strategy);
+        }
+
+        /// Веса полос приоритета. Доставка попадает в полосу по старшему
+        /// приоритету обработчиков этого типа на исполнителе.
+        void SetQueueWeights(const TQueueWeights& Weights) {
+            Queue.SetWeights(Weights);
+        }
+
+        /// eventfd исполнителя для epoll (-1 вне Linux).
+        int GetWakeupFd() const {
+            return Queue.GetWakeupFd();
+        }
+
+        /// Количество ожидающих доставок.
+        std::size_t GetQueueSize() const {
+            return Queue.Size();
+        }
+
+    private:
+        friend class TEventSystem;
+
+        NInternal::TEventQueue Queue;
+    };
+
+} // namespace NEventSystem
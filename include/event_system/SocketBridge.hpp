@@ -0,0 +1,407 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "event_system/EventSystem.hpp"
+
+// Мост между TEventSystem разных процессов через Unix domain socket.
+// Использует sendmmsg/recvmmsg, поэтому доступен только на Linux.
+
+namespace NEventSystem {
+
+    /// События, которые можно передать через мост побайтовой копией.
+    template <typename T>
+    concept BridgeableEvent =
+        EventConstraint<T> && std::is_trivially_copyable_v<T>;
+
+    namespace NInternal {
+
+        /// Заголовок записи внутри кадра моста.
+        /// Кадр — одно сообщение SOCK_SEQPACKET: подряд идущие записи
+        /// [заголовок][байты события] без выравнивания.
+        struct TBridgeRecordHeader {
+            std::uint32_t Tag;
+            std::uint32_t Size;
+        };
+
+    } // namespace NInternal
+
+    /// Отправляющая сторона моста.
+    /// Подписывается на выбранные типы событий и копит их в кадры,
+    /// которые уходят в сокет пачкой через sendmmsg.
+    /// Fd — подключённый сокет AF_UNIX типа SOCK_SEQPACKET, владение не передаётся.
+    ///
+    /// Сам отправитель шлёт кадры, только когда накопилось MaxFramesPerFlush
+    /// кадров или (см. SetMaxDelay) когда очередное событие пришло позже
+    /// MaxDelay после первого неотправленного. Без новых событий хвост
+    /// лежит в кадре, поэтому вызывающий обязан звать Flush() — обычно
+    /// в конце кадра или пачки диспетчеризации.
+    class TSocketBridgeSender {
+    public:
+        static constexpr std::size_t DefaultFrameBytes = 16 * 1024;
+        static constexpr std::size_t MaxFramesPerFlush = 32;
+
+        TSocketBridgeSender(TEventSystem& system, int fd,
+                            std::size_t frameBytes = DefaultFrameBytes)
+            : System(&system)
+            , Fd(fd)
+            , FrameBytes(frameBytes) {
+        }
+
+        TSocketBridgeSender(const TSocketBridgeSender&) = delete;
+        TSocketBridgeSender& operator=(const TSocketBridgeSender&) = delete;
+
+        /// Отписывается от событий и пытается отправить остаток.
+        ~TSocketBridgeSender() {
+            Connections.clear();
+            try {
+                Flush();
+            } catch (...) {
+            }
+        }
+
+        /// Пересылать события TEvent под меткой Tag.
+        /// Метка должна совпадать с той, что передана в Route на приёмнике.
+        template <BridgeableEvent TEvent>
+        void Forward(std::uint32_t Tag,
+                     TPriority priority = TEventSystem::Priority::Low) {
+            if (sizeof(NInternal::TBridgeRecordHeader) + sizeof(TEvent) > FrameBytes) {
+                throw std::length_error("event does not fit into bridge frame");
+            }
+
+            const auto Id = System->Subscribe<TEvent>(
+                priority,
+                [this, Tag](const TEvent& Event) {
+                    Append(Tag, &Event, sizeof(TEvent));
+                });
+            Connections.emplace_back(*System, Id);
+        }
+
+        /// Отправлять накопленное из Forward-обработчика, если первое
+        /// неотправленное событие ждёт дольше Delay. Ноль — отправлять
+        /// каждое событие сразу. По умолчанию без ограничения.
+        void SetMaxDelay(std::chrono::nanoseconds Delay) {
+            std::lock_guard lock(Mutex);
+            MaxDelay = Delay;
+        }
+
+        /// Отправить все накопленные кадры.
+        void Flush() {
+            std::lock_guard lock(Mutex);
+            FlushUnlocked();
+        }
+
+        /// Количество заполняемых и ещё не отправленных кадров.
+        std::size_t GetPendingFrames() const {
+            std::lock_guard lock(Mutex);
+            return UsedFrames;
+        }
+
+    private:
+        void Append(std::uint32_t Tag, const void* Data, std::size_t Size) {
+            const NInternal::TBridgeRecordHeader Header{
+                Tag, static_cast<std::uint32_t>(Size)};
+            const std::size_t RecordSize = sizeof(Header) + Size;
+
+            std::lock_guard lock(Mutex);
+
+            if (UsedFrames == 0 || Frames[UsedFrames - 1].size() + RecordSize > FrameBytes) {
+                if (UsedFrames == MaxFramesPerFlush) {
+                    FlushUnlocked();
+                }
+                OpenFrameUnlocked();
+            }
+
+            auto& Frame = Frames[UsedFrames - 1];
+            const std::size_t Offset = Frame.size();
+            Frame.resize(Offset + RecordSize);
+            std::memcpy(Frame.data() + Offset, &Header, sizeof(Header));
+            std::memcpy(Frame.data() + Offset + sizeof(Header), Data, Size);
+
+            if (MaxDelay != NoDelayLimit) {
+                const auto Now = TClock::now();
+                if (UsedFrames == 1 && Offset == 0) {
+                    OldestPending = Now;
+                }
+                if (Now - OldestPending >= MaxDelay) {
+                    FlushUnlocked();
+                }
+            }
+        }
+
+        void OpenFrameUnlocked() {
+            if (UsedFrames == Frames.size()) {
+                Frames.emplace_back().reserve(FrameBytes);
+            } else {
+                Frames[UsedFrames].clear();
+            }
+            ++UsedFrames;
+        }
+
+        void FlushUnlocked() {
+            if (UsedFrames == 0) {
+                return;
+            }
+
+            std::array<iovec, MaxFramesPerFlush> Iov{};
+            std::array<mmsghdr, MaxFramesPerFlush> Msgs{};
+            for (std::size_t i = 0; i < UsedFrames; ++i) {
+                Iov[i].iov_base = Frames[i].data();
+                Iov[i].iov_len = Frames[i].size();
+                Msgs[i].msg_hdr.msg_iov = &Iov[i];
+                Msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            std::size_t Sent = 0;
+            while (Sent < UsedFrames) {
+                const int Res = ::sendmmsg(Fd, Msgs.data() + Sent,
+                                           static_cast<unsigned>(UsedFrames - Sent), 0);
+                if (Res < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    const int Error = errno;
+                    // Ушедшие кадры убираем, чтобы следующий Flush не отправил их повторно.
+                    std::rotate(Frames.begin(), Frames.begin() + static_cast<std::ptrdiff_t>(Sent),
+                                Frames.begin() + static_cast<std::ptrdiff_t>(UsedFrames));
+                    UsedFrames -= Sent;
+                    throw std::system_error(Error, std::generic_category(), "sendmmsg");
+                }
+                Sent += static_cast<std::size_t>(Res);
+            }
+
+            UsedFrames = 0;
+        }
+
+        // --------- Данные ---------
+
+        using TClock = std::chrono::steady_clock;
+        static constexpr auto NoDelayLimit = std::chrono::nanoseconds::max();
+
+        TEventSystem* System;
+        int Fd;
+        std::size_t FrameBytes;
+
+        mutable std::mutex Mutex;
+        std::chrono::nanoseconds MaxDelay = NoDelayLimit;
+        /// Когда появилось первое неотправленное событие.
+        TClock::time_point OldestPending{};
+        std::vector<std::vector<std::byte>> Frames;
+        std::size_t UsedFrames = 0;
+
+        std::vector<TEventSystem::TScopedConnection> Connections;
+    };
+
+    /// Принимающая сторона моста.
+    /// Вычитывает кадры пачкой через recvmmsg и повторно диспетчеризует
+    /// события локально: подряд идущие события одного типа уходят одним
+    /// DispatchBatch.
+    class TSocketBridgeReceiver {
+    public:
+        static constexpr std::size_t MaxFramesPerReceive = 32;
+
+        TSocketBridgeReceiver(TEventSystem& system, int fd,
+                              std::size_t frameBytes = TSocketBridgeSender::DefaultFrameBytes)
+            : System(&system)
+            , Fd(fd)
+            , FrameBytes(frameBytes)
+            , Buffer(frameBytes * MaxFramesPerReceive) {
+        }
+
+        TSocketBridgeReceiver(const TSocketBridgeReceiver&) = delete;
+        TSocketBridgeReceiver& operator=(const TSocketBridgeReceiver&) = delete;
+
+        /// Доставлять записи с меткой Tag как события TEvent.
+        /// Записи с незарегистрированными метками пропускаются.
+        template <BridgeableEvent TEvent>
+        void Route(std::uint32_t Tag) {
+            Routes[Tag] = std::make_unique<TRoute<TEvent>>();
+        }
+
+        /// Принять доступные кадры и диспетчеризовать их содержимое.
+        /// При Wait == true блокируется до прихода хотя бы одного кадра.
+        /// Возвращает количество доставленных событий.
+        ///
+        /// Если обработчик бросил исключение, оно уходит наружу, а кадры,
+        /// уже вычитанные из сокета, не теряются: следующий Receive сначала
+        /// доразбирает их с записи, на которой остановился. Теряется только
+        /// остаток пакета DispatchBatch, в котором случилось исключение.
+        /// Обрезанный кадр (длиннее frameBytes) отбрасывается целиком
+        /// с length_error.
+        std::size_t Receive(bool Wait = true) {
+            if (NextFrame == ReceivedFrames) {
+                std::array<iovec, MaxFramesPerReceive> Iov{};
+                std::array<mmsghdr, MaxFramesPerReceive> Msgs{};
+                for (std::size_t i = 0; i < MaxFramesPerReceive; ++i) {
+                    Iov[i].iov_base = Buffer.data() + i * FrameBytes;
+                    Iov[i].iov_len = FrameBytes;
+                    Msgs[i].msg_hdr.msg_iov = &Iov[i];
+                    Msgs[i].msg_hdr.msg_iovlen = 1;
+                }
+
+                int Res = 0;
+                do {
+                    Res = ::recvmmsg(Fd, Msgs.data(), MaxFramesPerReceive,
+                                     Wait ? MSG_WAITFORONE : MSG_DONTWAIT, nullptr);
+                } while (Res < 0 && errno == EINTR);
+
+                if (Res < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                        return 0;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "recvmmsg");
+                }
+
+                for (int i = 0; i < Res; ++i) {
+                    FrameLengths[i] = (Msgs[i].msg_hdr.msg_flags & MSG_TRUNC) ? TruncatedFrame : Msgs[i].msg_len;
+                }
+                ReceivedFrames = static_cast<std::size_t>(Res);
+                NextFrame = 0;
+                NextOffset = 0;
+            }
+
+            std::size_t Delivered = 0;
+            while (NextFrame < ReceivedFrames) {
+                const std::size_t Length = FrameLengths[NextFrame];
+                if (Length == TruncatedFrame) {
+                    SkipFrame();
+                    throw std::length_error("bridge frame exceeds receiver frame size");
+                }
+                if (Length == 0) {
+                    PeerClosed = true;
+                } else {
+                    Delivered += ProcessFrame(
+                        std::span<const std::byte>(Buffer.data() + NextFrame * FrameBytes, Length));
+                }
+                SkipFrame();
+            }
+            return Delivered;
+        }
+
+        /// Кадры, вычитанные из сокета, но ещё не разобранные
+        /// (остались после исключения в обработчике).
+        std::size_t GetPendingFrames() const {
+            return ReceivedFrames - NextFrame;
+        }
+
+        /// Отправитель закрыл соединение.
+        bool IsPeerClosed() const {
+            return PeerClosed;
+        }
+
+    private:
+        struct TRouteBase {
+            virtual ~TRouteBase() = default;
+            virtual bool Push(const std::byte* Data, std::size_t Size) = 0;
+            virtual void Flush(TEventSystem& System) = 0;
+        };
+
+        template <typename TEvent>
+        struct TRoute: TRouteBase {
+            std::vector<TEvent> Batch;
+
+            bool Push(const std::byte* Data, std::size_t Size) override {
+                if (Size != sizeof(TEvent)) {
+                    return false;
+                }
+                std::array<std::byte, sizeof(TEvent)> Raw;
+                std::memcpy(Raw.data(), Data, sizeof(TEvent));
+                Batch.push_back(std::bit_cast<TEvent>(Raw));
+                return true;
+            }
+
+            void Flush(TEventSystem& System) override {
+                if (Batch.empty()) {
+                    return;
+                }
+                try {
+                    System.DispatchBatch(std::span<const TEvent>(Batch));
+                } catch (...) {
+                    Batch.clear();
+                    throw;
+                }
+                Batch.clear();
+            }
+        };
+
+        void SkipFrame() {
+            ++NextFrame;
+            NextOffset = 0;
+        }
+
+        /// Разобрать кадр с NextOffset. Перед каждым DispatchBatch NextOffset
+        /// сдвигается за отданные записи, чтобы после исключения продолжить
+        /// со следующей.
+        std::size_t ProcessFrame(std::span<const std::byte> Frame) {
+            std::size_t Delivered = 0;
+            TRouteBase* Current = nullptr;
+
+            std::size_t Offset = NextOffset;
+            while (Offset + sizeof(NInternal::TBridgeRecordHeader) <= Frame.size()) {
+                const std::size_t RecordStart = Offset;
+                NInternal::TBridgeRecordHeader Header;
+                std::memcpy(&Header, Frame.data() + Offset, sizeof(Header));
+                Offset += sizeof(Header);
+                if (Offset + Header.Size > Frame.size()) {
+                    break;
+                }
+
+                auto it = Routes.find(Header.Tag);
+                TRouteBase* Route = it == Routes.end() ? nullptr : it->second.get();
+                if (Route != Current && Current) {
+                    NextOffset = RecordStart;
+                    Current->Flush(*System);
+                }
+                Current = Route;
+
+                if (Route && Route->Push(Frame.data() + Offset, Header.Size)) {
+                    ++Delivered;
+                }
+                Offset += Header.Size;
+            }
+
+            if (Current) {
+                NextOffset = Frame.size();
+                Current->Flush(*System);
+            }
+            return Delivered;
+        }
+
+        // --------- Данные ---------
+
+        TEventSystem* System;
+        int Fd;
+        std::size_t FrameBytes;
+
+        static constexpr std::size_t TruncatedFrame = static_cast<std::size_t>(-1);
+
+        std::vector<std::byte> Buffer;
+        /// Длины кадров последнего recvmmsg (TruncatedFrame — обрезан).
+        std::array<std::size_t, MaxFramesPerReceive> FrameLengths{};
+        std::size_t ReceivedFrames = 0;
+        /// Следующий неразобранный кадр и смещение в нём.
+        std::size_t NextFrame = 0;
+        std::size_t NextOffset = 0;
+        std::unordered_map<std::uint32_t, std::unique_ptr<TRouteBase>> Routes;
+        bool PeerClosed = false;
+    };
+
+} // namespace NEventSystem
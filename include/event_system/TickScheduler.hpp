@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "event_system/EventSystem.hpp"
+
+namespace NEventSystem {
+
+    /// Итог одного Advance планировщика тиков.
+    struct TTickReport {
+        std::size_t Ticks = 0;   ///< Доставлено тиков.
+        std::size_t Dropped = 0; ///< Тиков отброшено сверх MaxCatchUp.
+        /// Доля шага, накопленная после тиков: для интерполяции отрисовки.
+        double Alpha = 0.0;
+        /// Время в обработчиках тиков.
+        std::chrono::nanoseconds HandlerTime{0};
+        /// Обработчики работали дольше, чем длится смоделированное время:
+        /// при такой нагрузке симуляция не догонит реальное время.
+        bool Overrun = false;
+    };
+
+    /// Планировщик фиксированного шага: копит реальное время в аккумуляторе
+    /// и доставляет событие тика TTickEvent каждые Step. Если кадр затянулся,
+    /// догоняющие тики (не больше MaxCatchUp) уходят одним DispatchBatch —
+    /// список обработчиков снимается один раз на пакет; излишек времени
+    /// отбрасывается, чтобы не уйти в «спираль смерти».
+    ///
+    /// Событие тика строится один раз при создании, каждый тик — его копия.
+    /// Advance вызывается одним потоком (обычно главным циклом).
+    template <EventConstraint TTickEvent>
+        requires std::copy_constructible<TTickEvent>
+    class TFixedTickScheduler {
+    public:
+        using TClock = std::chrono::steady_clock;
+        using TDuration = std::chrono::nanoseconds;
+
+        /// Tick — событие одного шага, например TPhysicsTickEvent{dt}.
+        TFixedTickScheduler(TEventSystem& system, TDuration step, std::size_t maxCatchUp, TTickEvent tick)
+            : System(&system)
+            , Step(step)
+            , Ticks(maxCatchUp, tick) {
+            if (Step <= TDuration::zero() || maxCatchUp == 0) {
+                throw std::invalid_argument("tick step and catch-up limit must be positive");
+            }
+        }
+
+        /// Шаг в секундах строит событие как TTickEvent{dt}.
+        TFixedTickScheduler(TEventSystem& system, TDuration step, std::size_t maxCatchUp = 5)
+            requires requires(float dt) { TTickEvent{dt}; }
+            : TFixedTickScheduler(system, step, maxCatchUp,
+                                  TTickEvent{std::chrono::duration<float>(step).count()}) {
+        }
+
+        TFixedTickScheduler(const TFixedTickScheduler&) = delete;
+        TFixedTickScheduler& operator=(const TFixedTickScheduler&) = delete;
+
+        /// Добавить FrameTime реального времени и доставить накопившиеся тики.
+        TTickReport Advance(TDuration FrameTime) {
+            Accumulator += std::max(FrameTime, TDuration::zero());
+
+            TTickReport Report;
+            const auto Due = static_cast<std::size_t>(Accumulator / Step);
+            Report.Ticks = std::min(Due, Ticks.size());
+            Report.Dropped = Due - Report.Ticks;
+            Accumulator -= Step * static_cast<std::int64_t>(Due);
+
+            if (Report.Ticks != 0) {
+                const auto Start = TClock::now();
+                System->DispatchBatch(std::span<const TTickEvent>(Ticks.data(), Report.Ticks));
+                Report.HandlerTime = TClock::now() - Start;
+                Report.Overrun = Report.HandlerTime > Step * static_cast<std::int64_t>(Report.Ticks);
+            }
+
+            TotalTicks += Report.Ticks;
+            TotalDropped += Report.Dropped;
+            Overruns += Report.Overrun ? 1 : 0;
+            Report.Alpha = GetAlpha();
+            return Report;
+        }
+
+        /// Advance на время, прошедшее с прошлого Update (первый вызов
+        /// только запоминает момент).
+        TTickReport Update() {
+            const auto Now = TClock::now();
+            const auto FrameTime = LastUpdate == TClock::time_point{} ? TDuration::zero() : Now - LastUpdate;
+            LastUpdate = Now;
+            return Advance(FrameTime);
+        }
+
+        /// Доля шага в аккумуляторе, [0, 1).
+        double GetAlpha() const noexcept {
+            return std::chrono::duration<double>(Accumulator) / std::chrono::duration<double>(Step);
+        }
+
+        TDuration GetStep() const noexcept {
+            return Step;
+        }
+
+        std::uint64_t GetTotalTicks() const noexcept {
+            return TotalTicks;
+        }
+
+        std::uint64_t GetTotalDropped() const noexcept {
+            return TotalDropped;
+        }
+
+        /// Сколько Advance закончились перерасходом (см. TTickReport::Overrun).
+        std::uint64_t GetOverruns() const noexcept {
+            return Overruns;
+        }
+
+    private:
+        TEventSystem* System;
+        TDuration Step;
+        TDuration Accumulator{0};
+        TClock::time_point LastUpdate{};
+        /// MaxCatchUp готовых копий тика: пакет — их префикс.
+        std::vector<TTickEvent> Ticks;
+
+        std::uint64_t TotalTicks = 0;
+        std::uint64_t TotalDropped = 0;
+        std::uint64_t Overruns = 0;
+    };
+
+} // namespace NEventSystem
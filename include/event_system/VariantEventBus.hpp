@@ -0,0 +1,276 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "event_system/EventSystem.hpp"
+
+namespace NEventSystem {
+
+    template <typename TVariant>
+    class TVariantEventBus;
+
+    /// Шина для закрытого набора типов событий, заданного std::variant.
+    /// События всех типов лежат в одном непрерывном буфере variant'ов
+    /// и разбираются в порядке постановки. Доставка идёт через таблицу
+    /// переходов, построенную на этапе компиляции по variant::index():
+    /// без type-erasure, аллокаций на событие и поиска в реестре.
+    ///
+    /// Enqueue потокобезопасен. Подписка, Dispatch и DrainReady
+    /// выполняются одним потоком-владельцем шины.
+    template <typename... TEvents>
+    class TVariantEventBus<std::variant<TEvents...>> {
+        static_assert((EventConstraint<TEvents> && ...),
+                      "Все альтернативы должны быть событиями");
+
+    public:
+        using TEventVariant = std::variant<TEvents...>;
+        using HandlerId = THandlerId;
+        using Priority = EPriority;
+        using PriorityValue = TPriority;
+
+        static constexpr std::size_t AlternativeCount = sizeof...(TEvents);
+
+        TVariantEventBus() = default;
+        TVariantEventBus(const TVariantEventBus&) = delete;
+        TVariantEventBus& operator=(const TVariantEventBus&) = delete;
+
+        /// Номер альтернативы TEvent в variant.
+        template <typename TEvent>
+        static consteval std::size_t IndexOf() {
+            constexpr bool Matches[] = {std::is_same_v<TEvent, TEvents>...};
+            std::size_t Found = AlternativeCount;
+            for (std::size_t i = 0; i < AlternativeCount; ++i) {
+                if (Matches[i]) {
+                    if (Found != AlternativeCount) {
+                        return AlternativeCount;
+                    }
+                    Found = i;
+                }
+            }
+            return Found;
+        }
+
+        template <typename TEvent>
+        static constexpr bool IsAlternative = IndexOf<TEvent>() < AlternativeCount;
+
+        template <typename TEvent, HandlerFor<TEvent> THandler>
+            requires IsAlternative<TEvent>
+        HandlerId Subscribe(TPriority priority, THandler&& handler) {
+            auto& List = std::get<IndexOf<TEvent>()>(Handlers);
+            const HandlerId Id = NextId++;
+
+            TSlot<TEvent> slot{Id, priority, TCallback<TEvent>(std::forward<THandler>(handler)), true};
+            if (DispatchDepth > 0) {
+                // Во время доставки список не трогаем: обработчик
+                // добавится после выхода из Dispatch.
+                List.Pending.push_back(std::move(slot));
+                Dirty = true;
+            } else {
+                InsertByPriority(List.Slots, std::move(slot));
+            }
+            return Id;
+        }
+
+        bool Unsubscribe(HandlerId Id) {
+            return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                return (RemoveFrom<Is>(Id) || ...);
+            }(std::index_sequence_for<TEvents...>{});
+        }
+
+        /// Синхронная доставка одного события.
+        void Dispatch(const TEventVariant& Event) {
+            if (Event.valueless_by_exception()) {
+                return;
+            }
+
+            static constexpr auto JumpTable = MakeJumpTable(std::index_sequence_for<TEvents...>{});
+            JumpTable[Event.index()](*this, Event);
+        }
+
+        /// Поставить событие в общий буфер.
+        void Enqueue(TEventVariant Event) {
+            std::lock_guard lock(QueueMutex);
+            Buffer.push_back(std::move(Event));
+        }
+
+        template <typename TEvent>
+            requires IsAlternative<std::remove_cvref_t<TEvent>>
+        void Enqueue(TEvent&& Event) {
+            std::lock_guard lock(QueueMutex);
+            Buffer.emplace_back(std::in_place_index<IndexOf<std::remove_cvref_t<TEvent>>()>,
+                                std::forward<TEvent>(Event));
+        }
+
+        /// Доставить все события, накопленные к моменту вызова, в порядке
+        /// постановки. Если обработчик бросил исключение, недоставленные
+        /// события возвращаются в начало буфера.
+        std::size_t DrainReady() {
+            std::vector<TEventVariant> Batch;
+            {
+                std::lock_guard lock(QueueMutex);
+                Batch.swap(Buffer);
+            }
+
+            std::size_t Done = 0;
+            try {
+                for (; Done < Batch.size(); ++Done) {
+                    Dispatch(Batch[Done]);
+                }
+            } catch (...) {
+                std::lock_guard lock(QueueMutex);
+                Buffer.insert(Buffer.begin(),
+                              std::make_move_iterator(Batch.begin() + static_cast<std::ptrdiff_t>(Done) + 1),
+                              std::make_move_iterator(Batch.end()));
+                throw;
+            }
+
+            // Возвращаем ёмкость буфера, чтобы не аллоцировать на каждом цикле.
+            Batch.clear();
+            std::lock_guard lock(QueueMutex);
+            if (Buffer.empty() && Buffer.capacity() < Batch.capacity()) {
+                Buffer.swap(Batch);
+            }
+            return Done;
+        }
+
+        std::size_t GetQueueSize() const {
+            std::lock_guard lock(QueueMutex);
+            return Buffer.size();
+        }
+
+        template <typename TEvent>
+            requires IsAlternative<TEvent>
+        std::size_t GetHandlerCount() const {
+            const auto& List = std::get<IndexOf<TEvent>()>(Handlers);
+            return static_cast<std::size_t>(std::count_if(
+                       List.Slots.begin(), List.Slots.end(),
+                       [](const auto& slot) { return slot.Active; })) +
+                   List.Pending.size();
+        }
+
+    private:
+        template <typename TEvent>
+        using TCallback = NInternal::THandlerThunk<NInternal::TEventArg<TEvent>>;
+
+        template <typename TEvent>
+        struct TSlot {
+            HandlerId Id;
+            TPriority Prio;
+            TCallback<TEvent> Callback;
+            bool Active;
+        };
+
+        template <typename TEvent>
+        struct TSlotList {
+            std::vector<TSlot<TEvent>> Slots;
+            std::vector<TSlot<TEvent>> Pending;
+        };
+
+        using TDispatchFn = void (*)(TVariantEventBus&, const TEventVariant&);
+
+        template <std::size_t... Is>
+        static constexpr std::array<TDispatchFn, AlternativeCount> MakeJumpTable(std::index_sequence<Is...>) {
+            return {&DispatchAlternative<Is>...};
+        }
+
+        template <std::size_t I>
+        static void DispatchAlternative(TVariantEventBus& Bus, const TEventVariant& Event) {
+            Bus.template Deliver<I>(*std::get_if<I>(&Event));
+        }
+
+        template <std::size_t I, typename TEvent>
+        void Deliver(const TEvent& Event) {
+            auto& Slots = std::get<I>(Handlers).Slots;
+
+            ++DispatchDepth;
+            TDepthGuard guard{*this};
+            for (auto& slot : Slots) {
+                if (slot.Active) {
+                    slot.Callback(Event);
+                }
+            }
+        }
+
+        /// Снимает уровень вложенности Dispatch и на внешнем уровне
+        /// применяет отложенные подписки и отписки.
+        struct TDepthGuard {
+            TVariantEventBus& Bus;
+
+            ~TDepthGuard() {
+                if (--Bus.DispatchDepth == 0 && Bus.Dirty) {
+                    Bus.ApplyDeferred();
+                }
+            }
+        };
+
+        void ApplyDeferred() {
+            Dirty = false;
+            std::apply([](auto&... Lists) {
+                (ApplyDeferred(Lists), ...);
+            },
+                       Handlers);
+        }
+
+        template <typename TEvent>
+        static void ApplyDeferred(TSlotList<TEvent>& List) {
+            std::erase_if(List.Slots, [](const TSlot<TEvent>& slot) { return !slot.Active; });
+            for (auto& slot : List.Pending) {
+                InsertByPriority(List.Slots, std::move(slot));
+            }
+            List.Pending.clear();
+        }
+
+        template <std::size_t I>
+        bool RemoveFrom(HandlerId Id) {
+            auto& List = std::get<I>(Handlers);
+
+            auto pending = std::find_if(List.Pending.begin(), List.Pending.end(),
+                                        [Id](const auto& slot) { return slot.Id == Id; });
+            if (pending != List.Pending.end()) {
+                List.Pending.erase(pending);
+                return true;
+            }
+
+            auto it = std::find_if(List.Slots.begin(), List.Slots.end(),
+                                   [Id](const auto& slot) { return slot.Id == Id && slot.Active; });
+            if (it == List.Slots.end()) {
+                return false;
+            }
+
+            if (DispatchDepth > 0) {
+                it->Active = false;
+                Dirty = true;
+            } else {
+                List.Slots.erase(it);
+            }
+            return true;
+        }
+
+        template <typename TEvent>
+        static void InsertByPriority(std::vector<TSlot<TEvent>>& Slots, TSlot<TEvent> slot) {
+            auto pos = std::upper_bound(
+                Slots.begin(), Slots.end(), slot.Prio,
+                [](TPriority prio, const TSlot<TEvent>& other) {
+                    return prio > other.Prio;
+                });
+            Slots.insert(pos, std::move(slot));
+        }
+
+        std::tuple<TSlotList<TEvents>...> Handlers;
+        HandlerId NextId = 1;
+        std::size_t DispatchDepth = 0;
+        bool Dirty = false;
+
+        mutable std::mutex QueueMutex;
+        std::vector<TEventVariant> Buffer;
+    };
+
+} // namespace NEventSystem
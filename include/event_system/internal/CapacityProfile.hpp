@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace NEventSystem::NInternal {
+
+    /// Наблюдённые пики одного типа события (или топика).
+    struct TCapacityHint {
+        std::size_t Handlers = 0;
+        std::size_t Queued = 0;
+    };
+
+    /// Профиль ёмкости: имя диспетчера ("type:<mangled>" или "topic:<name>") → пики.
+    /// Пики полос очереди лежат под именами QueueLaneProfileNames
+    /// (Handlers у них 0): очередь общая, и сумма пиков по типам её завышает.
+    using TCapacityProfile = std::map<std::string, TCapacityHint>;
+
+    /// Имена полос очереди в профиле, в порядке High, Normal, Low.
+    inline constexpr std::array<const char*, 3> QueueLaneProfileNames{"queue:high", "queue:normal", "queue:low"};
+
+    inline constexpr const char* CapacityProfileHeader = "# event_system capacity profile v1";
+
+    /// Формат — текст, по строке на тип: "<handlers> <queued> <name>".
+    /// Имя идёт последним и может содержать пробелы, но не '\n'
+    /// (InternTopic такие имена не пропускает).
+    inline void WriteCapacityProfile(const std::filesystem::path& Path, const TCapacityProfile& Profile) {
+        std::ofstream Out(Path, std::ios::trunc);
+        Out << CapacityProfileHeader << '\n';
+        for (const auto& [Name, Hint] : Profile) {
+            Out << Hint.Handlers << ' ' << Hint.Queued << ' ' << Name << '\n';
+        }
+
+        Out.flush();
+        if (!Out) {
+            throw std::runtime_error("cannot write capacity profile: " + Path.string());
+        }
+    }
+
+    /// Прочитать профиль. Возвращает false, если файла нет или он
+    /// не похож на профиль; некорректные строки пропускаются.
+    inline bool ReadCapacityProfile(const std::filesystem::path& Path, TCapacityProfile& Profile) {
+        std::ifstream In(Path);
+        std::string Line;
+        if (!In || !std::getline(In, Line) || Line != CapacityProfileHeader) {
+            return false;
+        }
+
+        while (std::getline(In, Line)) {
+            std::istringstream Fields(Line);
+            TCapacityHint Hint;
+            std::string Name;
+            if (!(Fields >> Hint.Handlers >> Hint.Queued) || !std::getline(Fields >> std::ws, Name) || Name.empty()) {
+                continue;
+            }
+            Profile[Name] = Hint;
+        }
+        return true;
+    }
+
+} // namespace NEventSystem::NInternal
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace NEventSystem::NInternal {
+
+    /// Календарная очередь элементов с дедлайном: кольцо корзин шириной
+    /// BucketWidth на BucketCount корзин вперёд от текущей, всё дальше
+    /// горизонта — в куче Far. Для почти монотонных дедлайнов вставка
+    /// и выборка — амортизированное O(1): текущая корзина сортируется
+    /// один раз при первом обращении, пустые корзины пролистываются,
+    /// а через пустое кольцо очередь прыгает сразу к ближайшему в Far.
+    /// Равные дедлайны выходят в порядке вставки. Потокобезопасность —
+    /// на стороне владельца.
+    template <typename TItem>
+    class TDeadlineQueue {
+    public:
+        using TClock = std::chrono::steady_clock;
+        using TTimePoint = TClock::time_point;
+
+        static constexpr auto BucketWidth = std::chrono::milliseconds(1);
+        static constexpr std::size_t BucketCount = 512;
+
+        bool Empty() const noexcept {
+            return Count == 0;
+        }
+
+        std::size_t Size() const noexcept {
+            return Count;
+        }
+
+        void Push(TTimePoint Deadline, const TItem& Item) {
+            TEntry Entry{Deadline, NextSeq++, Item};
+            const std::int64_t Index = BucketOf(Deadline);
+
+            if (Count == 0 || (Near == 0 && Index < Base)) {
+                // Пустое кольцо переносим к новому элементу, чтобы не листать корзины.
+                Base = Index;
+                CurrentSorted = false;
+            }
+
+            ++Count;
+            if (Index >= Base + static_cast<std::int64_t>(BucketCount)) {
+                Far.push_back(std::move(Entry));
+                std::push_heap(Far.begin(), Far.end(), std::greater<>{});
+                return;
+            }
+
+            // Просроченное относительно текущей корзины попадает в неё же.
+            Place(std::max(Index, Base), std::move(Entry));
+        }
+
+        /// Достать элемент с наименьшим дедлайном. Очередь не пуста.
+        TItem Pop(TTimePoint& Deadline) {
+            auto& Bucket = CurrentBucket();
+            TEntry Entry = std::move(Bucket.back());
+            Bucket.pop_back();
+            --Near;
+            --Count;
+
+            Deadline = Entry.Deadline;
+            return std::move(Entry.Item);
+        }
+
+        /// Дедлайн ближайшего элемента. Очередь не пуста.
+        TTimePoint Top() {
+            return CurrentBucket().back().Deadline;
+        }
+
+    private:
+        struct TEntry {
+            TTimePoint Deadline;
+            std::uint64_t Seq;
+            TItem Item;
+
+            /// Для кучи Far (min-heap через std::greater).
+            friend bool operator>(const TEntry& a, const TEntry& b) {
+                return a.Deadline != b.Deadline ? a.Deadline > b.Deadline : a.Seq > b.Seq;
+            }
+        };
+
+        static std::int64_t BucketOf(TTimePoint Deadline) {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(Deadline.time_since_epoch()).count() /
+                   BucketWidth.count();
+        }
+
+        static std::size_t SlotOf(std::int64_t Index) {
+            const auto Count = static_cast<std::int64_t>(BucketCount);
+            return static_cast<std::size_t>(((Index % Count) + Count) % Count);
+        }
+
+        /// Корзина с ближайшими дедлайнами, отсортированная по убыванию
+        /// (ближайший — в конце). Сортируется один раз при переходе на неё,
+        /// дальше порядок поддерживает Place.
+        std::vector<TEntry>& CurrentBucket() {
+            for (;;) {
+                if (Near == 0) {
+                    Base = BucketOf(Far.front().Deadline);
+                    CurrentSorted = false;
+                }
+                PullFar();
+
+                auto& Bucket = Buckets[SlotOf(Base)];
+                if (!Bucket.empty()) {
+                    if (!CurrentSorted) {
+                        std::sort(Bucket.begin(), Bucket.end(), std::greater<>{});
+                        CurrentSorted = true;
+                    }
+                    return Bucket;
+                }
+
+                ++Base;
+                CurrentSorted = false;
+            }
+        }
+
+        /// Перенести из Far всё, что попало в горизонт кольца.
+        void PullFar() {
+            const std::int64_t Horizon = Base + static_cast<std::int64_t>(BucketCount);
+            while (!Far.empty() && BucketOf(Far.front().Deadline) < Horizon) {
+                std::pop_heap(Far.begin(), Far.end(), std::greater<>{});
+                const std::int64_t Slot = std::max(BucketOf(Far.back().Deadline), Base);
+                Place(Slot, std::move(Far.back()));
+                Far.pop_back();
+            }
+        }
+
+        /// Положить элемент в корзину кольца. В уже отсортированную текущую
+        /// корзину — бинарной вставкой, чтобы не сортировать её заново.
+        void Place(std::int64_t Slot, TEntry&& Entry) {
+            auto& Bucket = Buckets[SlotOf(Slot)];
+            if (Slot == Base && CurrentSorted) {
+                Bucket.insert(std::upper_bound(Bucket.begin(), Bucket.end(), Entry, std::greater<>{}),
+                              std::move(Entry));
+            } else {
+                Bucket.push_back(std::move(Entry));
+            }
+            ++Near;
+        }
+
+        std::array<std::vector<TEntry>, BucketCount> Buckets;
+        std::vector<TEntry> Far;
+        /// Номер текущей корзины (в единицах BucketWidth от эпохи часов).
+        std::int64_t Base = 0;
+        std::size_t Near = 0;
+        std::size_t Count = 0;
+        std::uint64_t NextSeq = 0;
+        bool CurrentSorted = false;
+    };
+
+} // namespace NEventSystem::NInternal
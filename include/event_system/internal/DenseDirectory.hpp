@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+
+#include "TypeId.hpp"
+
+namespace NEventSystem::NInternal {
+
+    /// Таблица указателей, индексированная плотным id типа или топика.
+    /// Чтение без блокировок: два acquire-чтения. Блоки по BlockSize
+    /// указателей выделяются при первой записи в их диапазон и больше
+    /// не перемещаются. Запись выполняется под внешней блокировкой.
+    /// Таблица не владеет объектами, на которые указывает.
+    template <typename T>
+    class TDenseDirectory {
+    public:
+        static constexpr std::size_t BlockBits = 6;
+        static constexpr std::size_t BlockSize = std::size_t{1} << BlockBits;
+        static constexpr std::size_t MaxBlocks = MaxDenseIds / BlockSize;
+
+        TDenseDirectory() = default;
+
+        ~TDenseDirectory() {
+            for (auto& Block : Blocks) {
+                delete[] Block.load(std::memory_order_relaxed);
+            }
+        }
+
+        TDenseDirectory(const TDenseDirectory&) = delete;
+        TDenseDirectory& operator=(const TDenseDirectory&) = delete;
+
+        T* Find(TTypeId Id) const noexcept {
+            const std::size_t Index = Id >> BlockBits;
+            if (Index >= MaxBlocks) {
+                return nullptr;
+            }
+
+            const auto* Block = Blocks[Index].load(std::memory_order_acquire);
+            return Block ? Block[Id & (BlockSize - 1)].load(std::memory_order_acquire) : nullptr;
+        }
+
+        /// Выделить блок под Id заранее: бросает std::length_error (или
+        /// bad_alloc) до того, как вызывающий что-то создал, после чего
+        /// Publish для этого Id уже не бросает.
+        void Prepare(TTypeId Id) {
+            EnsureBlock(Id >> BlockBits);
+        }
+
+        void Publish(TTypeId Id, T* Value) {
+            EnsureBlock(Id >> BlockBits)[Id & (BlockSize - 1)].store(Value, std::memory_order_release);
+        }
+
+        /// Выделить блоки для id [0, Count), чтобы первая запись не аллоцировала.
+        void Reserve(std::size_t Count) {
+            for (std::size_t Index = 0; Index * BlockSize < Count; ++Index) {
+                EnsureBlock(Index);
+            }
+        }
+
+    private:
+        std::atomic<T*>* EnsureBlock(std::size_t Index) {
+            if (Index >= MaxBlocks) {
+                throw std::length_error("dense id is out of dispatcher directory range");
+            }
+
+            auto* Block = Blocks[Index].load(std::memory_order_relaxed);
+            if (!Block) {
+                Block = new std::atomic<T*>[BlockSize]();
+                Blocks[Index].store(Block, std::memory_order_release);
+            }
+            return Block;
+        }
+
+        std::array<std::atomic<std::atomic<T*>*>, MaxBlocks> Blocks{};
+    };
+
+} // namespace NEventSystem::NInternal
@@ -2,130 +2,460 @@
 
 #include <algorithm>
 #include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
+#include <queue>
 #include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "EventQueue.hpp"
+#include "HandlerThunk.hpp"
 #include "IDispatcher.hpp"
+#include "SharedEvent.hpp"
+#include "SpatialGrid.hpp"
 
 namespace NEventSystem::NInternal {
 
     /// Диспетчер для конкретного типа события EventType.
+    /// Создаётся через make_shared: доставки исполнителям держат его живым.
     template <typename TEvent>
-    class TDispatcher: public TIDispatcher {
+    class TDispatcher: public TIDispatcher, public std::enable_shared_from_this<TDispatcher<TEvent>> {
     public:
-        using Callback = std::function<void(const TEvent&)>;
+        using EventType = TEvent;
 
-        struct TSlot {
+        /// Обработчик: сигнатура вызова выбирается на этапе компиляции
+        /// (по значению для маленьких trivially copyable событий).
+        using Callback = THandlerThunk<TEventArg<TEvent>>;
+        /// Стадия конвейера: получает событие по неконстантной ссылке.
+        using StageCallback = std::function<void(TEvent&)>;
+        /// Сток: последний получатель, забирает событие во владение.
+        using SinkCallback = std::function<void(TEvent&&)>;
+
+        template <typename TCallback>
+        struct TBasicSlot {
             THandlerId Id;
-            EPriority Priority;
-            Callback CallbackV;
+            /// Меняется только под записью (SetPriority). Слот разделён
+            /// с опубликованными таблицами, поэтому Dispatch берёт приоритет
+            /// из таблицы (TTable::Priorities), а не отсюда; у подписок
+            /// по области он не меняется вовсе.
+            TPriority Priority;
+            TCallback CallbackV;
             bool IsOneShot;
             std::atomic<bool> Active;
+            /// Приостановленный обработчик остаётся подписанным, но пропускается.
+            std::atomic<bool> Paused;
+            /// Очередь исполнителя для асинхронного обработчика (nullptr — вызов в Dispatch).
+            TEventQueue* Executor;
+            /// Метка и ограничения Before/After (nullptr — только приоритет).
+            std::shared_ptr<const TOrdering> Ordering;
+            /// Позиция в опубликованной таблице (меняется только под записью).
+            std::size_t Index = 0;
+            /// Вызываемый объект после Replace. Пока замен не было, Replaced
+            /// ложно и вызывается CallbackV без лишних атомарных операций;
+            /// после замены вызов берёт копию указателя под коротким спин-локом
+            /// слота, так что заменённый объект доживает до конца идущего вызова.
+            /// Не std::atomic<std::shared_ptr>: в libstdc++ 12 его load снимает
+            /// внутреннюю блокировку с relaxed-порядком, и чтение указателя
+            /// не упорядочено с записью следующего Replace.
+            std::shared_ptr<const TCallback> Replacement;
+            mutable std::atomic_flag ReplacementLock;
+            std::atomic<bool> Replaced{false};
+            /// Слот учтён в счётчике Listening (см. SyncListening).
+            std::atomic<bool> Counted{false};
 
-            TSlot(THandlerId id_,
-                  EPriority PriorityV,
-                  Callback Cb,
-                  bool OneShot)
+            TBasicSlot(THandlerId id_,
+                       TPriority PriorityV,
+                       TCallback Cb,
+                       bool OneShot,
+                       TEventQueue* ExecutorV = nullptr,
+                       std::shared_ptr<const TOrdering> OrderingV = nullptr)
                 : Id(id_)
                 , Priority(PriorityV)
                 , CallbackV(std::move(Cb))
                 , IsOneShot(OneShot)
-                , Active(true) {
+                , Active(true)
+                , Paused(false)
+                , Executor(ExecutorV)
+                , Ordering(std::move(OrderingV)) {
+            }
+
+            std::shared_ptr<const TCallback> LoadReplacement() const noexcept {
+                LockReplacement();
+                auto Target = Replacement;
+                ReplacementLock.clear(std::memory_order_release);
+                return Target;
+            }
+
+            /// Поставить новый объект; прежний возвращается, чтобы вызывающий
+            /// освободил его вне спин-лока.
+            std::shared_ptr<const TCallback> StoreReplacement(std::shared_ptr<const TCallback> Target) noexcept {
+                LockReplacement();
+                Replacement.swap(Target);
+                ReplacementLock.clear(std::memory_order_release);
+                Replaced.store(true, std::memory_order_release);
+                return Target;
+            }
+
+        private:
+            void LockReplacement() const noexcept {
+                while (ReplacementLock.test_and_set(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
             }
         };
 
-        TDispatcher() = default;
+        using TSlot = TBasicSlot<Callback>;
+        using TStageSlot = TBasicSlot<StageCallback>;
+        using TSinkSlot = TBasicSlot<SinkCallback>;
+
+        /// Опубликованная неизменяемая таблица обработчиков.
+        /// Live — упакованная битовая маска синхронных обработчиков, которых
+        /// сейчас нужно вызывать (активных, не на паузе, без исполнителя).
+        /// Dispatch обходит только установленные биты, так что отписанные,
+        /// приостановленные и сработавшие одноразовые слоты ничего не стоят.
+        /// Биты — подсказка: у найденного слота флаги всё равно проверяются.
+        struct TTable {
+            std::vector<std::shared_ptr<TStageSlot>> Stages;
+            std::vector<std::shared_ptr<TSlot>> Slots;
+            std::vector<TEventQueue*> Executors;
+            /// Полоса очереди для каждого исполнителя: по старшему приоритету
+            /// его обработчиков этого типа.
+            std::vector<std::uint8_t> ExecutorLanes;
+            std::shared_ptr<TSinkSlot> Sink;
+            /// Подписки с областью интереса (nullptr, пока их не было).
+            std::shared_ptr<const TSpatialGrid<TSlot>> Spatial;
+            /// Приоритеты Slots на момент публикации; заполняются, только
+            /// если есть Spatial (порядок слияния с подписчиками по области).
+            std::vector<TPriority> Priorities;
+            std::unique_ptr<std::atomic<std::uint64_t>[]> Live;
+            std::size_t Words = 0;
+
+            void SetLive(std::size_t Index, bool Value) const noexcept {
+                const std::uint64_t Bit = std::uint64_t{1} << (Index % 64);
+                if (Value) {
+                    Live[Index / 64].fetch_or(Bit, std::memory_order_release);
+                } else {
+                    Live[Index / 64].fetch_and(~Bit, std::memory_order_release);
+                }
+            }
+        };
+
+        /// Снимок — ссылка на опубликованную таблицу: снимается за O(1).
+        using TSnapshot = std::shared_ptr<const TTable>;
+
+        TDispatcher()
+            : Current(std::make_shared<TTable>()) {
+        }
+
         ~TDispatcher() override = default;
 
         TDispatcher(const TDispatcher&) = delete;
         TDispatcher& operator=(const TDispatcher&) = delete;
 
         /// Подписка обработчика (внутренняя, вызывается из EventSystem).
+        /// Если у кого-то из обработчиков есть ограничения порядка, список
+        /// пересобирается топологической сортировкой; при цикле бросается
+        /// std::logic_error и список не меняется.
         void Subscribe(THandlerId Id,
-                       EPriority Priority,
+                       TPriority Priority,
                        Callback Callback,
-                       bool OneShot) {
-            auto slot = std::make_shared<TSlot>(Id, Priority, std::move(Callback), OneShot);
+                       bool OneShot,
+                       TEventQueue* Executor = nullptr,
+                       std::shared_ptr<const TOrdering> Ordering = nullptr) {
+            auto slot = MakeSlot<TSlot>(Id, Priority, std::move(Callback), OneShot, Executor,
+                                        std::move(Ordering));
+            auto* Raw = slot.get();
 
             std::unique_lock lock(Mutex);
-            Slots.push_back(std::move(slot));
+            if (slot->Ordering || HasOrderingUnlocked()) {
+                ReorderUnlocked(std::move(slot));
+            } else {
+                InsertByPriority(Slots, std::move(slot));
+            }
 
-            std::stable_sort(
-                Slots.begin(), Slots.end(),
-                [](const std::shared_ptr<TSlot>& a,
-                   const std::shared_ptr<TSlot>& b) {
-                    return static_cast<int>(a->Priority) >
-                           static_cast<int>(b->Priority);
-                });
+            if (Executor && std::find(Executors.begin(), Executors.end(), Executor) == Executors.end()) {
+                Executors.push_back(Executor);
+            }
+            PublishUnlocked();
+            SyncListening(*Raw);
+        }
+
+        /// Подписка стадии конвейера: стадии выполняются до всех
+        /// константных обработчиков, в порядке приоритета.
+        void SubscribeStage(THandlerId Id,
+                            TPriority Priority,
+                            StageCallback Callback,
+                            bool OneShot) {
+            auto slot = MakeSlot<TStageSlot>(Id, Priority, std::move(Callback), OneShot);
+            auto* Raw = slot.get();
+
+            std::unique_lock lock(Mutex);
+            InsertByPriority(Stages, std::move(slot));
+            PublishUnlocked();
+            SyncListening(*Raw);
+        }
+
+        /// Подписка стока (не более одного на тип события).
+        /// Возвращает false, если активный сток уже есть.
+        bool SubscribeSink(THandlerId Id, SinkCallback Callback) {
+            auto slot = MakeSlot<TSinkSlot>(Id, EPriority::Low, std::move(Callback), false);
+
+            std::unique_lock lock(Mutex);
+            if (Sink && Sink->Active.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            Sink = std::move(slot);
+            PublishUnlocked();
+            SyncListening(*Sink);
+            return true;
+        }
+
+        /// Подписка с областью интереса: обработчик получает только события,
+        /// позиция которых попадает в Region. Сетка создаётся при первой
+        /// такой подписке; дальше подписки и смена областей меняют её на
+        /// месте, без публикации новой таблицы.
+        void SubscribeInRegion(THandlerId Id, TPriority Priority, Callback Callback, const TRegion& Region)
+            requires PositionalEvent<TEvent>
+        {
+            auto slot = MakeSlot<TSlot>(Id, Priority, std::move(Callback), false);
+            auto* Raw = slot.get();
+
+            std::unique_lock lock(Mutex);
+            if (!Spatial) {
+                auto Grid = std::make_shared<TSpatialGrid<TSlot>>(CellSizeOf<TEvent>());
+                Grid->Insert(std::move(slot), Region);
+                Spatial = std::move(Grid);
+                PublishUnlocked();
+            } else {
+                Spatial->Insert(std::move(slot), Region);
+            }
+            SyncListening(*Raw);
+        }
+
+        bool MoveRegion(THandlerId Id, const TRegion& Region) {
+            std::shared_lock lock(Mutex);
+            return Spatial && Spatial->Move(Id, Region);
         }
 
-        /// Логическое удаление обработчика по Id.
+        /// Логическое удаление обработчика по Id. Синхронный слот остаётся
+        /// в таблице надгробием: гасится только его бит, остальные слоты
+        /// не перебираются.
         bool Remove(THandlerId Id) override {
             std::unique_lock lock(Mutex);
+            if (Sink && Sink->Id == Id) {
+                Quench(*Sink);
+            } else if (auto slot = FindById(Slots, Id)) {
+                if (Quench(*slot)) {
+                    NoteDead(*slot);
+                }
+                Current->SetLive(slot->Index, false);
+            } else if (auto stage = FindById(Stages, Id)) {
+                Quench(*stage);
+                CompactPending.store(true, std::memory_order_relaxed);
+            } else {
+                auto region = Spatial ? Spatial->Remove(Id) : nullptr;
+                if (!region) {
+                    return false;
+                }
+                Quench(*region);
+            }
+
+            CleanupUnlocked();
+            return true;
+        }
+
+        /// Под записью: флаг паузы и бит в маске Live меняются вместе,
+        /// так что параллельные Pause и Resume не разойдутся с маской.
+        bool SetPaused(THandlerId Id, bool PausedV) override {
+            std::unique_lock lock(Mutex);
+            auto Mark = [&](const auto& slot) {
+                if (slot && slot->Id == Id && slot->Active.load(std::memory_order_relaxed)) {
+                    if (slot->Paused.exchange(PausedV, std::memory_order_acq_rel) != PausedV) {
+                        SyncListening(*slot);
+                    }
+                    return true;
+                }
+                return false;
+            };
+
+            auto it = std::find_if(Slots.begin(), Slots.end(), Mark);
+            if (it != Slots.end()) {
+                Current->SetLive((*it)->Index, IsLive(**it));
+                return true;
+            }
+
+            return std::any_of(Stages.begin(), Stages.end(), Mark) || Mark(Sink) ||
+                   (Spatial && Mark(Spatial->Find(Id)));
+        }
+
+        void Reserve(std::size_t ExpectedHandlers) override {
+            std::unique_lock lock(Mutex);
+            Slots.reserve(ExpectedHandlers);
+        }
+
+        /// Снять все подписки разом. Слоты гасятся, так что чужие снимки их
+        /// уже не вызовут; сами слоты разрушаются после снятия блокировки,
+        /// и их память возвращается в пул диспетчера, а не в кучу по одному.
+        void Clear() override {
+            std::vector<std::shared_ptr<TSlot>> OldSlots;
+            std::vector<std::shared_ptr<TStageSlot>> OldStages;
+            std::shared_ptr<TSinkSlot> OldSink;
+            std::shared_ptr<const TTable> OldTable;
+            std::vector<std::shared_ptr<TSlot>> OldRegions;
+
+            std::unique_lock lock(Mutex);
+            auto QuenchAll = [this](const auto& slot) {
+                Quench(*slot);
+            };
+            std::for_each(Slots.begin(), Slots.end(), QuenchAll);
+            std::for_each(Stages.begin(), Stages.end(), QuenchAll);
+            if (Sink) {
+                QuenchAll(Sink);
+            }
+            if (Spatial) {
+                OldRegions = Spatial->Clear();
+                std::for_each(OldRegions.begin(), OldRegions.end(), QuenchAll);
+            }
+
+            OldSlots.swap(Slots);
+            OldStages.swap(Stages);
+            OldSink.swap(Sink);
+            OldTable = Current;
+            Executors.clear();
+            Dead.store(0, std::memory_order_relaxed);
+            CompactPending.store(false, std::memory_order_relaxed);
+            PublishUnlocked();
+            lock.unlock();
+        }
+
+        TCapacityStats GetCapacityStats() const override {
+            std::shared_lock lock(Mutex);
+            return {PeakHandlers, PeakQueued.load(std::memory_order_relaxed), Slots.capacity()};
+        }
+
+        /// Учёт событий этого типа в очереди отложенной доставки.
+        void NoteQueued() noexcept {
+            const std::size_t Depth = Queued.fetch_add(1, std::memory_order_relaxed) + 1;
+            std::size_t Peak = PeakQueued.load(std::memory_order_relaxed);
+            while (Depth > Peak && !PeakQueued.compare_exchange_weak(Peak, Depth, std::memory_order_relaxed)) {
+            }
+        }
+
+        void NoteDequeued() noexcept {
+            Queued.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        /// Есть ли сейчас хоть один активный обработчик не на паузе
+        /// (любого вида). Чтение без блокировок: счётчик ведётся
+        /// при подписке, отписке, паузе и срабатывании одноразового.
+        bool IsListening() const noexcept {
+            return Listening.load(std::memory_order_acquire) > 0;
+        }
+
+        /// Заменить вызываемый объект обработчика в том же слоте: Id,
+        /// приоритет, место, пауза и подписка не меняются. Идущий Dispatch
+        /// вызывает либо старый, либо новый объект, но не пропускает
+        /// обработчик. Объект, подписанный изначально, хранится в слоте
+        /// до его удаления; объекты прошлых замен освобождаются сразу
+        /// после последнего вызова. Заменяются обычные обработчики
+        /// и подписки по области; у стадий конвейера и стока другая
+        /// сигнатура, для них возвращается false.
+        bool Replace(THandlerId Id, Callback NewCallback) {
+            auto Target = std::make_shared<const Callback>(std::move(NewCallback));
+            std::shared_ptr<const Callback> Previous;
+
+            std::shared_lock lock(Mutex);
             auto it = std::find_if(
                 Slots.begin(), Slots.end(),
                 [Id](const std::shared_ptr<TSlot>& slot) {
-                    return slot->Id == Id;
+                    return slot->Id == Id && slot->Active.load(std::memory_order_relaxed);
                 });
 
-            if (it == Slots.end()) {
+            TSlot* slot = it != Slots.end() ? it->get() : nullptr;
+            std::shared_ptr<TSlot> Region;
+            if (!slot && Spatial) {
+                Region = Spatial->Find(Id);
+                if (Region && Region->Active.load(std::memory_order_relaxed)) {
+                    slot = Region.get();
+                }
+            }
+            if (!slot) {
                 return false;
             }
 
-            (*it)->Active.store(false, std::memory_order_release);
-
-            CleanupUnlocked();
+            Previous = slot->StoreReplacement(std::move(Target));
             return true;
         }
 
-        /// Обычная диспетчеризация события.
-        /// Используется EventSystem::dispatch.
-        void Dispatch(const TEvent& event) {
-            std::vector<std::shared_ptr<TSlot>> snapshot;
-            {
-                std::shared_lock lock(Mutex);
-                snapshot = Slots;
+        bool SetPriority(THandlerId Id, TPriority Priority) override {
+            std::unique_lock lock(Mutex);
+            if (Reprioritize(Stages, Id, Priority)) {
+                PublishUnlocked();
+                return true;
+            }
+            if (!Reprioritize(Slots, Id, Priority)) {
+                return false;
             }
 
-            bool NeedCleanup = false;
+            if (HasOrderingUnlocked()) {
+                ReorderUnlocked(nullptr);
+            }
+            PublishUnlocked();
+            return true;
+        }
 
-            try {
-                for (const auto& slot : snapshot) {
-                    if (slot->IsOneShot) {
-                        bool expected = true;
-                        if (!slot->Active.compare_exchange_strong(
-                                expected,
-                                false,
-                                std::memory_order_acq_rel,
-                                std::memory_order_acquire)) {
-                            continue;
-                        }
+        /// Снимок текущего списка обработчиков.
+        TSnapshot TakeSnapshot() const {
+            std::shared_lock lock(Mutex);
+            return Current;
+        }
 
-                        NeedCleanup = true;
-                        slot->CallbackV(event);
-                        continue;
-                    }
+        /// Обычная диспетчеризация события.
+        /// Используется EventSystem::dispatch.
+        void Dispatch(const TEvent& event) {
+            DispatchSnapshot(TakeSnapshot(), event);
+        }
 
-                    if (!slot->Active.load(std::memory_order_acquire)) {
-                        continue;
-                    }
+        /// Диспетчеризация события, которым владеет вызывающий:
+        /// стадии конвейера меняют его на месте.
+        void Dispatch(TEvent& event) {
+            DispatchSnapshot(TakeSnapshot(), event);
+        }
 
-                    slot->CallbackV(event);
-                }
-            } catch (...) {
-                if (NeedCleanup) {
-                    Cleanup();
-                }
-                throw;
+        /// Диспетчеризация по заранее снятому снимку.
+        /// Позволяет пакетной доставке снимать список обработчиков один раз.
+        /// Если есть стадии конвейера, они работают с копией события.
+        void DispatchSnapshot(const TSnapshot& snapshot, const TEvent& event) {
+            if (snapshot->Stages.empty()) {
+                RunSnapshot(snapshot, event);
+                return;
             }
 
-            if (NeedCleanup) {
-                Cleanup();
+            if constexpr (std::copy_constructible<TEvent>) {
+                TEvent Copy(event);
+                RunSnapshot(snapshot, Copy);
+            } else {
+                throw std::logic_error("mutable stages of a move-only event require Dispatch(TEvent&&)");
             }
         }
 
+        void DispatchSnapshot(const TSnapshot& snapshot, TEvent& event) {
+            RunSnapshot(snapshot, event);
+        }
+
         /// Вызвать ровно один обработчик по Id.
         /// Используется EventSystem при подписке во время dispatch,
         /// чтобы новый обработчик поучаствовал в текущей диспетчеризации.
@@ -147,26 +477,240 @@ namespace NEventSystem::NInternal {
                 slot = *it;
             }
 
+            // Асинхронный обработчик начнёт получать события со следующего Dispatch.
             bool NeedCleanup = false;
+            if (slot->Executor || !TryEnter(*slot, NeedCleanup)) {
+                return;
+            }
 
-            if (slot->IsOneShot) {
+            try {
+                Call(*slot, Event);
+            } catch (...) {
+                if (NeedCleanup) {
+                    Cleanup();
+                }
+                throw;
+            }
+
+            if (NeedCleanup) {
+                Cleanup();
+            }
+        }
+
+        /// Количество активных обработчиков.
+        std::size_t Count() const override {
+            std::shared_lock lock(Mutex);
+            const bool HasSink = Sink && Sink->Active.load(std::memory_order_relaxed);
+            return CountActive(Slots) + CountActive(Stages) + (HasSink ? 1 : 0) + CountRegions();
+        }
+
+    private:
+        using TEventPool = TSharedEventPool<TEvent>;
+        using TBlock = typename TEventPool::TBlock;
+
+        /// Слот и его счётчик ссылок — одна аллокация из пула диспетчера.
+        template <typename TSlotType, typename... TArgs>
+        std::shared_ptr<TSlotType> MakeSlot(TArgs&&... Args) {
+            return std::allocate_shared<TSlotType>(std::pmr::polymorphic_allocator<TSlotType>(&SlotPool),
+                                                   std::forward<TArgs>(Args)...);
+        }
+
+        /// Проверить, что слот нужно вызвать. Одноразовый слот при этом
+        /// захватывается (и помечается к очистке).
+        template <typename TSlotType>
+        bool TryEnter(TSlotType& slot, bool& NeedCleanup) noexcept {
+            if (slot.Paused.load(std::memory_order_acquire)) {
+                return false;
+            }
+
+            if (slot.IsOneShot) {
                 bool Expected = true;
-                if (!slot->Active.compare_exchange_strong(
+                if (!slot.Active.compare_exchange_strong(
                         Expected,
                         false,
                         std::memory_order_acq_rel,
                         std::memory_order_acquire)) {
-                    return;
+                    return false;
                 }
+                SyncListening(slot);
+                NoteDead(slot);
                 NeedCleanup = true;
+                return true;
+            }
+
+            return slot.Active.load(std::memory_order_acquire);
+        }
+
+        /// Вызвать текущий вызываемый объект слота (с учётом Replace).
+        template <typename TEventRef>
+        static void Call(const TSlot& slot, TEventRef& event) {
+            if (slot.Replaced.load(std::memory_order_acquire)) {
+                const auto Target = slot.LoadReplacement();
+                (*Target)(event);
             } else {
-                if (!slot->Active.load(std::memory_order_acquire)) {
-                    return;
+                slot.CallbackV(event);
+            }
+        }
+
+        /// Общий проход по снимку. Для неконстантного события сначала
+        /// выполняются стадии конвейера, а сток получает его через move;
+        /// константное событие сток получает копией.
+        template <typename TEventRef>
+        void RunSnapshot(const TSnapshot& snapshot, TEventRef& event) {
+            bool NeedCleanup = false;
+
+            try {
+                if constexpr (!std::is_const_v<TEventRef>) {
+                    for (const auto& stage : snapshot->Stages) {
+                        if (!TryEnter(*stage, NeedCleanup)) {
+                            continue;
+                        }
+                        stage->CallbackV(event);
+                    }
+                }
+
+                if (!snapshot->Executors.empty()) {
+                    PostAsync(*snapshot, event);
                 }
+
+                if constexpr (PositionalEvent<TEvent>) {
+                    if (snapshot->Spatial) {
+                        RunWithSpatial(*snapshot, event, NeedCleanup);
+                    } else {
+                        RunLive(*snapshot, event, NeedCleanup, [](std::size_t) {});
+                    }
+                } else {
+                    RunLive(*snapshot, event, NeedCleanup, [](std::size_t) {});
+                }
+
+                if (snapshot->Sink && TryEnter(*snapshot->Sink, NeedCleanup)) {
+                    if constexpr (!std::is_const_v<TEventRef>) {
+                        snapshot->Sink->CallbackV(std::move(event));
+                    } else if constexpr (std::copy_constructible<TEvent>) {
+                        snapshot->Sink->CallbackV(TEvent(event));
+                    } else {
+                        throw std::logic_error("sink of a move-only event requires Dispatch(TEvent&&)");
+                    }
+                }
+            } catch (...) {
+                if (NeedCleanup) {
+                    Cleanup();
+                }
+                throw;
+            }
+
+            if (NeedCleanup) {
+                Cleanup();
+            }
+        }
+
+        /// Обойти живые синхронные обработчики таблицы. BeforeSlot получает
+        /// индекс очередного обработчика в таблице до его вызова. Бит сработавшего
+        /// одноразового гасится в обходимой таблице сразу.
+        template <typename TEventRef, typename TBeforeSlot>
+        void RunLive(const TTable& Table, TEventRef& event, bool& NeedCleanup, TBeforeSlot&& BeforeSlot) {
+            const auto& TableSlots = Table.Slots;
+            for (std::size_t Word = 0; Word < Table.Words; ++Word) {
+                std::uint64_t Bits = Table.Live[Word].load(std::memory_order_acquire);
+                while (Bits != 0) {
+                    const auto Bit = static_cast<std::size_t>(std::countr_zero(Bits));
+                    auto& slot = *TableSlots[Word * 64 + Bit];
+                    Bits &= Bits - 1;
+                    BeforeSlot(Word * 64 + Bit);
+                    if (TryEnter(slot, NeedCleanup)) {
+                        if (slot.IsOneShot) {
+                            Table.SetLive(Word * 64 + Bit, false);
+                        }
+                        Call(slot, event);
+                    }
+                }
+            }
+        }
+
+        /// Обычные обработчики вперемешку с подписчиками, чья область
+        /// содержит позицию события: подписчик по области вызывается перед
+        /// первым обычным обработчиком с меньшим приоритетом (при равном —
+        /// после обычных). Цели копируются в буфер потока, который живёт
+        /// между событиями, так что Dispatch не аллоцирует; вложенный
+        /// Dispatch дописывает свои цели в хвост и убирает их за собой.
+        template <typename TEventRef>
+        void RunWithSpatial(const TTable& Table, TEventRef& event, bool& NeedCleanup) {
+            thread_local std::vector<std::shared_ptr<TSlot>> Targets;
+
+            struct TTrim {
+                std::size_t Start;
+
+                ~TTrim() {
+                    Targets.resize(Start);
+                }
+            } Trim{Targets.size()};
+
+            Table.Spatial->Collect(TPositionOf<TEvent>::Get(std::as_const(event)), Targets);
+
+            std::size_t Next = Trim.Start;
+            auto RunTargets = [&](auto&& Before) {
+                while (Next < Targets.size() && Before(Targets[Next]->Priority)) {
+                    // Сырой указатель: вложенный Dispatch может перевыделить буфер.
+                    auto* slot = Targets[Next++].get();
+                    if (TryEnter(*slot, NeedCleanup)) {
+                        Call(*slot, event);
+                    }
+                }
+            };
+
+            RunLive(Table, event, NeedCleanup, [&](std::size_t Index) {
+                RunTargets([Priority = Table.Priorities[Index]](TPriority Other) { return Other > Priority; });
+            });
+            RunTargets([](TPriority) { return true; });
+        }
+
+        /// Положить событие в один разделяемый блок и отправить указатель
+        /// на него в очередь каждого исполнителя.
+        void PostAsync(const TTable& Table, const TEvent& Event) {
+            const auto& Targets = Table.Executors;
+            auto* Block = Pool.Acquire(static_cast<std::uint32_t>(Targets.size()), this->shared_from_this(), Event);
+
+            std::size_t Posted = 0;
+            try {
+                for (; Posted < Targets.size(); ++Posted) {
+                    Targets[Posted]->Push({Block, Targets[Posted], &RunAsync, &DropAsync, TypeIdOf<TEvent>(),
+                                           nullptr, Table.ExecutorLanes[Posted]});
+                }
+            } catch (...) {
+                for (; Posted < Targets.size(); ++Posted) {
+                    TEventPool::Release(Block);
+                }
+                throw;
+            }
+        }
+
+        static void RunAsync(void* Payload, void* Context) {
+            auto* Block = static_cast<TBlock*>(Payload);
+            try {
+                static_cast<TDispatcher*>(Block->Owner.get())->RunOnExecutor(static_cast<TEventQueue*>(Context), Block->Event());
+            } catch (...) {
+                TEventPool::Release(Block);
+                throw;
             }
+            TEventPool::Release(Block);
+        }
+
+        static void DropAsync(void* Payload, void*) {
+            TEventPool::Release(static_cast<TBlock*>(Payload));
+        }
+
+        /// Вызвать обработчики, привязанные к исполнителю Executor.
+        void RunOnExecutor(TEventQueue* Executor, const TEvent& Event) {
+            const auto snapshot = TakeSnapshot();
+            bool NeedCleanup = false;
 
             try {
-                slot->CallbackV(Event);
+                for (const auto& slot : snapshot->Slots) {
+                    if (slot->Executor != Executor || !TryEnter(*slot, NeedCleanup)) {
+                        continue;
+                    }
+                    Call(*slot, Event);
+                }
             } catch (...) {
                 if (NeedCleanup) {
                     Cleanup();
@@ -179,34 +723,401 @@ namespace NEventSystem::NInternal {
             }
         }
 
-        /// Количество активных обработчиков.
-        std::size_t Count() const override {
-            std::shared_lock lock(Mutex);
+        /// Вставка после всех обработчиков с приоритетом не ниже данного:
+        /// позиция ищется бинарным поиском, порядок равных сохраняется.
+        template <typename TSlotType>
+        static void InsertByPriority(std::vector<std::shared_ptr<TSlotType>>& List,
+                                     std::shared_ptr<TSlotType> slot) {
+            auto pos = std::partition_point(
+                List.begin(), List.end(),
+                [&slot](const std::shared_ptr<TSlotType>& other) {
+                    return other->Priority >= slot->Priority;
+                });
+            List.insert(pos, std::move(slot));
+        }
+
+        /// Перенести слот на место по новому приоритету (последним среди
+        /// равных). Слот двигается поворотом внутри вектора, без аллокаций.
+        template <typename TSlotType>
+        static bool Reprioritize(std::vector<std::shared_ptr<TSlotType>>& List,
+                                 THandlerId Id,
+                                 TPriority Priority) {
+            auto it = std::find_if(
+                List.begin(), List.end(),
+                [Id](const std::shared_ptr<TSlotType>& slot) {
+                    return slot->Id == Id && slot->Active.load(std::memory_order_relaxed);
+                });
+
+            if (it == List.end()) {
+                return false;
+            }
+
+            std::rotate(it, it + 1, List.end());
+            List.back()->Priority = Priority;
+
+            auto pos = std::partition_point(
+                List.begin(), List.end() - 1,
+                [Priority](const std::shared_ptr<TSlotType>& other) {
+                    return other->Priority >= Priority;
+                });
+            std::rotate(pos, List.end() - 1, List.end());
+            return true;
+        }
+
+        /// Текст ошибки для цикла, на котором встал алгоритм Кана. Среди
+        /// неразмещённых узлов (InDegree != 0) есть и те, что лишь зависят
+        /// от цикла; у каждого неразмещённого есть неразмещённый предшественник,
+        /// так что проход по предшественникам приходит на цикл. В сообщение
+        /// идёт его компонента сильной связности.
+        static std::string DescribeCycle(const std::vector<std::shared_ptr<TSlot>>& List,
+                                         const std::vector<std::vector<std::size_t>>& Next,
+                                         const std::vector<std::size_t>& InDegree) {
+            const std::size_t Count = List.size();
+            std::vector<std::vector<std::size_t>> Prev(Count);
+            for (std::size_t i = 0; i < Count; ++i) {
+                for (const std::size_t j : Next[i]) {
+                    if (InDegree[i] != 0 && InDegree[j] != 0) {
+                        Prev[j].push_back(i);
+                    }
+                }
+            }
+
+            std::size_t OnCycle = 0;
+            while (InDegree[OnCycle] == 0) {
+                ++OnCycle;
+            }
+            std::vector<bool> Seen(Count, false);
+            while (!Seen[OnCycle]) {
+                Seen[OnCycle] = true;
+                OnCycle = Prev[OnCycle].front();
+            }
+
+            auto Reach = [&](auto&& Edges) {
+                std::vector<bool> Reached(Count, false);
+                std::vector<std::size_t> Stack{OnCycle};
+                Reached[OnCycle] = true;
+                while (!Stack.empty()) {
+                    const std::size_t i = Stack.back();
+                    Stack.pop_back();
+                    for (const std::size_t j : Edges[i]) {
+                        if (InDegree[j] != 0 && !Reached[j]) {
+                            Reached[j] = true;
+                            Stack.push_back(j);
+                        }
+                    }
+                }
+                return Reached;
+            };
+            const auto Forward = Reach(Next);
+            const auto Backward = Reach(Prev);
+
+            std::string Message = "handler ordering cycle between:";
+            for (std::size_t i = 0; i < Count; ++i) {
+                if (!Forward[i] || !Backward[i]) {
+                    continue;
+                }
+                Message += ' ';
+                if (List[i]->Ordering && !List[i]->Ordering->Label.empty()) {
+                    Message += List[i]->Ordering->Label;
+                } else {
+                    Message += '#' + std::to_string(List[i]->Id);
+                }
+            }
+            return Message;
+        }
+
+        /// Порядок вызова с учётом ограничений Before/After: алгоритм Кана,
+        /// среди готовых первым идёт тот, кто раньше по приоритету и подписке.
+        /// Результат кешируется в Slots, так что Dispatch за ограничения не платит.
+        static void ResolveOrdering(std::vector<std::shared_ptr<TSlot>>& List) {
+            std::sort(List.begin(), List.end(),
+                      [](const std::shared_ptr<TSlot>& a, const std::shared_ptr<TSlot>& b) {
+                          if (a->Priority != b->Priority) {
+                              return a->Priority > b->Priority;
+                          }
+                          return a->Id < b->Id;
+                      });
+
+            const std::size_t Count = List.size();
+            std::unordered_map<std::string_view, std::vector<std::size_t>> ByLabel;
+            for (std::size_t i = 0; i < Count; ++i) {
+                if (List[i]->Ordering && !List[i]->Ordering->Label.empty()) {
+                    ByLabel[List[i]->Ordering->Label].push_back(i);
+                }
+            }
+
+            std::vector<std::vector<std::size_t>> Next(Count);
+            std::vector<std::size_t> InDegree(Count, 0);
+            auto AddEdges = [&](std::size_t From, const std::string& Label, bool Forward) {
+                auto it = ByLabel.find(Label);
+                if (it == ByLabel.end()) {
+                    return;
+                }
+                for (const std::size_t Other : it->second) {
+                    if (Other == From) {
+                        continue;
+                    }
+                    const std::size_t Tail = Forward ? From : Other;
+                    const std::size_t Head = Forward ? Other : From;
+                    Next[Tail].push_back(Head);
+                    ++InDegree[Head];
+                }
+            };
+
+            for (std::size_t i = 0; i < Count; ++i) {
+                if (const auto& Ordering = List[i]->Ordering) {
+                    for (const auto& Label : Ordering->Before) {
+                        AddEdges(i, Label, true);
+                    }
+                    for (const auto& Label : Ordering->After) {
+                        AddEdges(i, Label, false);
+                    }
+                }
+            }
+
+            std::priority_queue<std::size_t, std::vector<std::size_t>, std::greater<>> Ready;
+            for (std::size_t i = 0; i < Count; ++i) {
+                if (InDegree[i] == 0) {
+                    Ready.push(i);
+                }
+            }
+
+            std::vector<std::shared_ptr<TSlot>> Ordered;
+            Ordered.reserve(Count);
+            while (!Ready.empty()) {
+                const std::size_t i = Ready.top();
+                Ready.pop();
+                Ordered.push_back(List[i]);
+                for (const std::size_t j : Next[i]) {
+                    if (--InDegree[j] == 0) {
+                        Ready.push(j);
+                    }
+                }
+            }
+
+            if (Ordered.size() != Count) {
+                throw std::logic_error(DescribeCycle(List, Next, InDegree));
+            }
+
+            List.swap(Ordered);
+        }
+
+        /// Есть ли у активных обработчиков ограничения порядка.
+        bool HasOrderingUnlocked() const {
+            return std::any_of(Slots.begin(), Slots.end(), [](const std::shared_ptr<TSlot>& slot) {
+                return slot->Ordering && slot->Active.load(std::memory_order_relaxed);
+            });
+        }
+
+        /// Пересобрать Slots (вместе с Added, если он есть) по ограничениям
+        /// порядка. Надгробия в пересборку не попадают: отписанный обработчик
+        /// с меткой не должен добавлять рёбра в граф. При цикле бросает
+        /// std::logic_error, и Slots не меняются.
+        void ReorderUnlocked(std::shared_ptr<TSlot> Added) {
+            std::vector<std::shared_ptr<TSlot>> Candidate;
+            Candidate.reserve(Slots.size() + 1);
+            std::copy_if(Slots.begin(), Slots.end(), std::back_inserter(Candidate),
+                         [](const std::shared_ptr<TSlot>& slot) { return slot->Active.load(std::memory_order_relaxed); });
+            const auto Erased = static_cast<std::ptrdiff_t>(Slots.size() - Candidate.size());
+            if (Added) {
+                Candidate.push_back(std::move(Added));
+            }
+
+            ResolveOrdering(Candidate);
+            Slots.swap(Candidate);
+            Dead.fetch_sub(Erased, std::memory_order_relaxed);
+        }
+
+        template <typename TSlotType>
+        static TSlotType* FindById(const std::vector<std::shared_ptr<TSlotType>>& List, THandlerId Id) {
+            auto it = std::find_if(
+                List.begin(), List.end(),
+                [Id](const std::shared_ptr<TSlotType>& slot) {
+                    return slot->Id == Id;
+                });
+            return it == List.end() ? nullptr : it->get();
+        }
+
+        /// Погасить слот и снять его вклад в Listening.
+        /// Возвращает true, если слот был активен.
+        template <typename TSlotType>
+        bool Quench(TSlotType& slot) noexcept {
+            const bool Was = slot.Active.exchange(false, std::memory_order_acq_rel);
+            SyncListening(slot);
+            return Was;
+        }
+
+        /// Учесть новое надгробие в Slots; стадии и асинхронные слоты
+        /// удаляются при ближайшей очистке.
+        template <typename TSlotType>
+        void NoteDead(const TSlotType& slot) noexcept {
+            if constexpr (std::is_same_v<TSlotType, TSlot>) {
+                Dead.fetch_add(1, std::memory_order_relaxed);
+                if (slot.Executor) {
+                    CompactPending.store(true, std::memory_order_relaxed);
+                }
+            } else {
+                CompactPending.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        template <typename TSlotType>
+        static bool Counts(const TSlotType& slot) noexcept {
+            return slot.Active.load(std::memory_order_acquire) && !slot.Paused.load(std::memory_order_acquire);
+        }
+
+        /// Привести вклад слота в Listening к его флагам. Одноразовый слот
+        /// гасится без блокировки, поэтому после обмена Counted флаги
+        /// перечитываются: последний, кто меняет Counted, видит итоговые
+        /// флаги, и счётчик сходится к числу слушающих слотов.
+        template <typename TSlotType>
+        void SyncListening(TSlotType& slot) noexcept {
+            for (;;) {
+                const bool Value = Counts(slot);
+                if (slot.Counted.exchange(Value, std::memory_order_acq_rel) != Value) {
+                    Listening.fetch_add(Value ? 1 : -1, std::memory_order_acq_rel);
+                }
+                if (Counts(slot) == Value) {
+                    return;
+                }
+            }
+        }
+
+        template <typename TSlotType>
+        static std::size_t CountActive(const std::vector<std::shared_ptr<TSlotType>>& List) {
             return static_cast<std::size_t>(std::count_if(
-                Slots.begin(), Slots.end(),
-                [](const std::shared_ptr<TSlot>& slot) {
+                List.begin(), List.end(),
+                [](const std::shared_ptr<TSlotType>& slot) {
                     return slot->Active.load(std::memory_order_relaxed);
                 }));
         }
 
-    private:
+        template <typename TSlotType>
+        static std::size_t EraseInactive(std::vector<std::shared_ptr<TSlotType>>& List) {
+            return std::erase_if(List, [](const std::shared_ptr<TSlotType>& slot) {
+                return !slot->Active.load(std::memory_order_relaxed);
+            });
+        }
+
         void Cleanup() {
             std::unique_lock lock(Mutex);
             CleanupUnlocked();
         }
 
+        static bool IsLive(const TSlot& slot) noexcept {
+            return !slot.Executor && slot.Active.load(std::memory_order_relaxed) &&
+                   !slot.Paused.load(std::memory_order_relaxed);
+        }
+
+        /// Уплотнение списков. Синхронные слоты остаются в таблице
+        /// надгробиями, пока их не станет больше половины; стадии, сток
+        /// и асинхронные слоты удаляются при ближайшей очистке.
         void CleanupUnlocked() {
-            Slots.erase(
-                std::remove_if(
+            const bool NeedCompact = CompactPending.exchange(false, std::memory_order_relaxed) ||
+                                     Dead.load(std::memory_order_relaxed) * 2 > static_cast<std::ptrdiff_t>(Slots.size()) ||
+                                     (Sink && !Sink->Active.load(std::memory_order_relaxed));
+            if (!NeedCompact) {
+                return;
+            }
+
+            // Одноразовый слот может сработать параллельно и учесть себя
+            // в Dead чуть позже, чем его здесь удалили: счётчик знаковый
+            // и сходится после его fetch_add.
+            Dead.fetch_sub(static_cast<std::ptrdiff_t>(EraseInactive(Slots)), std::memory_order_relaxed);
+            EraseInactive(Stages);
+            if (Sink && !Sink->Active.load(std::memory_order_relaxed)) {
+                Sink.reset();
+            }
+
+            std::erase_if(Executors, [this](TEventQueue* Executor) {
+                return std::none_of(
                     Slots.begin(), Slots.end(),
-                    [](const std::shared_ptr<TSlot>& slot) {
-                        return !slot->Active.load(std::memory_order_relaxed);
-                    }),
-                Slots.end());
+                    [Executor](const std::shared_ptr<TSlot>& slot) {
+                        return slot->Executor == Executor;
+                    });
+            });
+            PublishUnlocked();
+        }
+
+        /// Собрать и опубликовать новую таблицу по текущим спискам.
+        void PublishUnlocked() {
+            auto Table = std::make_shared<TTable>();
+            Table->Stages = Stages;
+            Table->Slots = Slots;
+            Table->Executors = Executors;
+            Table->ExecutorLanes.reserve(Executors.size());
+            for (TEventQueue* Executor : Executors) {
+                std::int16_t Top = TPriority::LowValue;
+                for (const auto& slot : Slots) {
+                    if (slot->Executor == Executor) {
+                        Top = std::max(Top, slot->Priority.Get());
+                    }
+                }
+                Table->ExecutorLanes.push_back(QueueLaneOf(Top));
+            }
+            Table->Sink = Sink;
+            Table->Spatial = Spatial;
+            if (Spatial) {
+                Table->Priorities.reserve(Slots.size());
+                for (const auto& slot : Slots) {
+                    Table->Priorities.push_back(slot->Priority);
+                }
+            }
+            Table->Words = (Slots.size() + 63) / 64;
+            Table->Live = std::make_unique<std::atomic<std::uint64_t>[]>(Table->Words);
+
+            std::size_t Active = 0;
+            for (std::size_t i = 0; i < Slots.size(); ++i) {
+                Slots[i]->Index = i;
+                Active += Slots[i]->Active.load(std::memory_order_relaxed) ? 1 : 0;
+                if (IsLive(*Slots[i])) {
+                    Table->SetLive(i, true);
+                }
+            }
+            Current = std::move(Table);
+
+            // Надгробия до уплотнения не считаются: иначе после оттока
+            // подписок профиль просил бы лишнюю ёмкость.
+            const bool HasSink = Sink && Sink->Active.load(std::memory_order_relaxed);
+            PeakHandlers = std::max(PeakHandlers, Active + CountActive(Stages) + (HasSink ? 1 : 0));
+        }
+
+        std::size_t CountRegions() const {
+            std::size_t Count = 0;
+            if (Spatial) {
+                Spatial->ForEachSlot([&](const std::shared_ptr<TSlot>& slot) {
+                    Count += slot->Active.load(std::memory_order_relaxed) ? 1 : 0;
+                });
+            }
+            return Count;
         }
 
         mutable std::shared_mutex Mutex;
+        /// Память слотов. Объявлен раньше всех владельцев слотов: при
+        /// разрушении диспетчера блоки пула отдаются системе целиком.
+        /// Слот может освободиться в любом потоке (с последним снимком),
+        /// поэтому пул синхронизированный.
+        std::pmr::synchronized_pool_resource SlotPool;
         std::vector<std::shared_ptr<TSlot>> Slots;
+        std::vector<std::shared_ptr<TStageSlot>> Stages;
+        std::shared_ptr<TSinkSlot> Sink;
+        std::shared_ptr<TSpatialGrid<TSlot>> Spatial;
+        /// Исполнители, на которых есть асинхронные обработчики.
+        std::vector<TEventQueue*> Executors;
+        /// Последняя опубликованная таблица; меняется только под записью.
+        std::shared_ptr<const TTable> Current;
+        /// Число активных обработчиков не на паузе (для DispatchLazy).
+        std::atomic<std::ptrdiff_t> Listening{0};
+        /// Надгробия в Slots; знаковый — см. CleanupUnlocked.
+        std::atomic<std::ptrdiff_t> Dead{0};
+        /// Есть погашенная стадия или асинхронный слот: уплотнить при очистке.
+        std::atomic<bool> CompactPending{false};
+
+        std::size_t PeakHandlers = 0;
+        std::atomic<std::size_t> Queued{0};
+        std::atomic<std::size_t> PeakQueued{0};
+
+        TEventPool Pool;
     };
 
 } // namespace NEventSystem::NInternal
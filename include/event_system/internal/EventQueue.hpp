@@ -0,0 +1,695 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include "DeadlineQueue.hpp"
+#include "TypeId.hpp"
+#include "WaitStrategy.hpp"
+
+#if defined(__linux__)
+    #include <sys/eventfd.h>
+    #include <unistd.h>
+#endif
+
+namespace NEventSystem {
+
+    /// Порядок доставки при выборке из очереди.
+    enum class EDrainOrder {
+        Fifo,       ///< Строго в порядке постановки.
+        GroupByType ///< Группами по типу события: FIFO внутри типа, между типами — нет.
+    };
+
+    /// Веса полос приоритета очереди: сколько событий полоса может выдать
+    /// за один круг, пока ждут и другие полосы. Все веса должны быть > 0,
+    /// поэтому Low не голодает при постоянном потоке High. События
+    /// с дедлайном — ещё один участник круга с весом Deadline, первый в нём.
+    struct TQueueWeights {
+        std::uint32_t High = 8;
+        std::uint32_t Normal = 4;
+        std::uint32_t Low = 1;
+        std::uint32_t Deadline = 8;
+    };
+
+    /// Количество элементов по полосам приоритета очереди.
+    struct TQueueLaneSizes {
+        std::size_t High = 0;
+        std::size_t Normal = 0;
+        std::size_t Low = 0;
+    };
+
+    /// Итог выборки с бюджетом времени (ProcessQueueFor).
+    struct TBudgetReport {
+        std::size_t Processed = 0;       ///< Обработано событий, включая просроченные.
+        std::size_t Deferred = 0;        ///< Осталось в очереди на следующий вызов.
+        std::chrono::nanoseconds Elapsed{0};
+    };
+
+} // namespace NEventSystem
+
+namespace NEventSystem::NInternal {
+
+    /// Полосы очереди: 0 — High, 1 — Normal, 2 — Low.
+    inline constexpr std::size_t QueueLaneCount = 3;
+
+    /// Полоса для приоритета — по тем же диапазонам, что и у TPriority:
+    /// [512, 32767] — High, [-512, 512) — Normal, [-32768, -512) — Low.
+    constexpr std::uint8_t QueueLaneOf(std::int16_t Priority) noexcept {
+        return Priority >= 512 ? 0 : (Priority < -512 ? 2 : 1);
+    }
+
+    /// Элемент очереди отложенной доставки.
+    /// Run доставляет событие и освобождает Payload,
+    /// Drop освобождает Payload без доставки.
+    /// RunBatch (необязателен) доставляет группу однотипных элементов
+    /// одним снимком обработчиков; Done увеличивается перед доставкой
+    /// каждого элемента, после чего элемент считается забранным.
+    /// Lane — полоса приоритета (QueueLaneOf). Элемент с Deadline идёт
+    /// не в полосу, а в очередь дедлайнов; если к выборке дедлайн прошёл,
+    /// вместо Run вызывается Expire (или Drop, если Expire не задан).
+    struct TQueuedItem {
+        using TTimePoint = std::chrono::steady_clock::time_point;
+        static constexpr TTimePoint NoDeadline = TTimePoint::max();
+
+        void* Payload = nullptr;
+        void* Context = nullptr;
+        void (*Run)(void* Payload, void* Context) = nullptr;
+        void (*Drop)(void* Payload, void* Context) = nullptr;
+        TTypeId Type = 0;
+        void (*RunBatch)(const TQueuedItem* Items, std::size_t Count, std::size_t& Done) = nullptr;
+        std::uint8_t Lane = QueueLaneOf(0);
+        TTimePoint Deadline = NoDeadline;
+        void (*Expire)(void* Payload, void* Context) = nullptr;
+    };
+
+    /// Очередь отложенной доставки с eventfd для интеграции в epoll-цикл.
+    /// Дескриптор становится читаемым при переходе очереди из пустого
+    /// состояния в непустое: на каждый такой переход — не более одной записи.
+    /// Для потребителей без epoll есть блокирующий WaitAndDrain
+    /// с настраиваемой стратегией ожидания.
+    ///
+    /// Элементы лежат в трёх полосах по приоритету. Выборка идёт взвешенным
+    /// циклом (deficit round robin): полоса отдаёт не больше своего веса
+    /// за круг, круги продолжаются между вызовами DrainReady. Пока ждут
+    /// несколько полос, High выходит раньше Normal и Low, но и Low получает
+    /// свою долю; если полоса одна, она разбирается без ограничений.
+    /// Элементы с дедлайном — отдельный участник того же круга, первый
+    /// в нём: внутри своей доли они идут по ближайшему дедлайну (EDF),
+    /// но не вытесняют полосы целиком; просроченные к моменту выборки
+    /// не доставляются и доли не тратят.
+    class TEventQueue {
+    public:
+        TEventQueue() {
+#if defined(__linux__)
+            WakeupFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (WakeupFd < 0) {
+                throw std::system_error(errno, std::generic_category(), "eventfd");
+            }
+#endif
+        }
+
+        ~TEventQueue() {
+            for (auto& Lane : Lanes) {
+                for (std::size_t i = Lane.Head; i < Lane.Items.size(); ++i) {
+                    Lane.Items[i].Drop(Lane.Items[i].Payload, Lane.Items[i].Context);
+                }
+            }
+            while (!Deadlines.Empty()) {
+                TQueuedItem::TTimePoint Deadline;
+                const auto Item = Deadlines.Pop(Deadline);
+                Item.Drop(Item.Payload, Item.Context);
+            }
+#if defined(__linux__)
+            ::close(WakeupFd);
+#endif
+        }
+
+        TEventQueue(const TEventQueue&) = delete;
+        TEventQueue& operator=(const TEventQueue&) = delete;
+
+        void Push(const TQueuedItem& Item) {
+            bool WasEmpty = false;
+            {
+                std::lock_guard lock(Mutex);
+                WasEmpty = Pending == 0 && Deadlines.Empty();
+                if (Item.Deadline != TQueuedItem::NoDeadline) {
+                    Deadlines.Push(Item.Deadline, Item);
+                } else {
+                    auto& Lane = Lanes[Item.Lane];
+                    Lane.Items.push_back(Item);
+                    Lane.Peak = std::max(Lane.Peak, Lane.Size());
+                    ++Pending;
+                }
+                if (WasEmpty) {
+                    SignalUnlocked();
+                }
+            }
+
+            if (WasEmpty) {
+                WaitPoint.Notify();
+            }
+        }
+
+        /// Доставить не более MaxBatch событий: элементы с дедлайном и полосы
+        /// по весам; элементы с дедлайном — по возрастанию дедлайна, внутри
+        /// полосы — в порядке постановки. GroupByType затем переставляет пакет по
+        /// типам (см. EDrainOrder). Просроченные элементы в MaxBatch не
+        /// входят, но учитываются в возвращаемом числе обработанных.
+        /// Если после выборки очередь пуста, дескриптор сбрасывается.
+        std::size_t DrainReady(std::size_t MaxBatch, EDrainOrder Order = EDrainOrder::Fifo) {
+            std::vector<TQueuedItem> Batch;
+            std::vector<TQueuedItem> Expired;
+            {
+                std::lock_guard lock(Mutex);
+                TakeBatchUnlocked(Batch, Expired, MaxBatch);
+            }
+            RunExpired(Expired, Batch);
+
+            if (Order == EDrainOrder::GroupByType) {
+                GroupByType(Batch);
+                RunGrouped(Batch);
+                return Expired.size() + Batch.size();
+            }
+
+            for (std::size_t i = 0; i < Batch.size(); ++i) {
+                try {
+                    Batch[i].Run(Batch[i].Payload, Batch[i].Context);
+                } catch (...) {
+                    Requeue(Batch.begin() + static_cast<std::ptrdiff_t>(i) + 1, Batch.end());
+                    throw;
+                }
+            }
+            return Expired.size() + Batch.size();
+        }
+
+        /// Доставлять события в том же порядке, что DrainReady, пока хватает
+        /// бюджета. Стоимость следующего события предсказывается по
+        /// скользящему среднему времени доставки его типа; если она не
+        /// укладывается в остаток, событие остаётся в очереди. Хотя бы одно
+        /// событие доставляется всегда, чтобы очередь не застряла на дорогом.
+        TBudgetReport DrainFor(std::chrono::nanoseconds Budget) {
+            using TClock = std::chrono::steady_clock;
+
+            const auto Start = TClock::now();
+            const auto Stop = Start + Budget;
+            TBudgetReport Report;
+            // Просроченные в Processed тоже входят, но гарантию «хотя бы
+            // одно событие» даёт только реально доставленное.
+            std::size_t Executed = 0;
+
+            std::vector<TQueuedItem> Batch;
+            std::vector<TQueuedItem> Expired;
+            for (;; Batch.clear(), Expired.clear()) {
+                {
+                    std::lock_guard lock(Mutex);
+                    TakeBatchUnlocked(Batch, Expired, 1);
+                }
+                RunExpired(Expired, Batch);
+                Report.Processed += Expired.size();
+                if (Batch.empty()) {
+                    if (Expired.empty()) {
+                        break;
+                    }
+                    continue;
+                }
+
+                auto& Item = Batch.front();
+                const auto Now = TClock::now();
+                if (Executed > 0 && Now + PredictCost(Item.Type) > Stop) {
+                    Requeue(Batch.begin(), Batch.end());
+                    break;
+                }
+
+                try {
+                    Item.Run(Item.Payload, Item.Context);
+                } catch (...) {
+                    NoteCost(Item.Type, TClock::now() - Now);
+                    throw;
+                }
+
+                NoteCost(Item.Type, TClock::now() - Now);
+                ++Executed;
+                ++Report.Processed;
+            }
+
+            Report.Elapsed = TClock::now() - Start;
+            Report.Deferred = Size();
+            return Report;
+        }
+
+        /// Блокирующая выборка: ждать событий по текущей стратегии и доставить
+        /// не более MaxBatch. Возвращает 0, если ожидание прервано Interrupt.
+        std::size_t WaitAndDrain(std::size_t MaxBatch) {
+            for (;;) {
+                const auto Observed = WaitEpoch();
+                if (const auto Delivered = DrainReady(MaxBatch)) {
+                    return Delivered;
+                }
+                if (ConsumeInterrupt()) {
+                    return 0;
+                }
+                WaitFor(Observed);
+            }
+        }
+
+        /// Поколение точки ожидания; снимается до проверки очереди.
+        std::uint32_t WaitEpoch() const noexcept {
+            return WaitPoint.Epoch();
+        }
+
+        void WaitFor(std::uint32_t Observed) noexcept {
+            WaitPoint.Wait(Observed);
+        }
+
+        /// Разбудить потребителей без новых событий в очереди
+        /// (например, при поступлении событий из другого источника).
+        void NotifyWaiters() noexcept {
+            WaitPoint.Notify();
+        }
+
+        /// Async-signal-safe пробуждение от сигнальных очередей EventSystem:
+        /// eventfd получает запись только на первом событии после
+        /// ConsumeSignalSources, потребители в WaitAndDrain просыпаются.
+        void NotifyWaitersFromSignal() noexcept {
+            if (!SignalSourcePending.exchange(true, std::memory_order_acq_rel)) {
+#if defined(__linux__)
+                const int SavedErrno = errno;
+                const std::uint64_t One = 1;
+                while (::write(WakeupFd, &One, sizeof(One)) < 0 && errno == EINTR) {
+                }
+                errno = SavedErrno;
+#endif
+            }
+            WaitPoint.NotifyFromSignal();
+        }
+
+        /// Снять отметку сигнальных очередей перед их разбором. Запись
+        /// обработчика сигнала в eventfd переходит под учёт Signaled, так что
+        /// выборка, опустошив очередь, сбросит дескриптор. Возвращает,
+        /// была ли отметка.
+        bool ConsumeSignalSources() {
+            std::lock_guard lock(Mutex);
+            if (!SignalSourcePending.exchange(false, std::memory_order_acq_rel)) {
+                return false;
+            }
+            Signaled = true;
+            return true;
+        }
+
+        /// Прервать одно ожидание в WaitAndDrain.
+        void Interrupt() noexcept {
+            Interrupted.store(true, std::memory_order_release);
+            WaitPoint.Notify();
+        }
+
+        bool ConsumeInterrupt() noexcept {
+            return Interrupted.exchange(false, std::memory_order_acq_rel);
+        }
+
+        void SetWaitStrategy(EWaitStrategy Strategy) noexcept {
+            WaitPoint.SetStrategy(Strategy);
+        }
+
+        EWaitStrategy GetWaitStrategy() const noexcept {
+            return WaitPoint.GetStrategy();
+        }
+
+        std::size_t Size() const {
+            std::lock_guard lock(Mutex);
+            return Pending + Deadlines.Size();
+        }
+
+        /// Выделить место под Capacity ожидающих элементов каждой полосы.
+        void Reserve(const TQueueLaneSizes& Capacity) {
+            std::lock_guard lock(Mutex);
+            const std::array<std::size_t, QueueLaneCount> Sizes{Capacity.High, Capacity.Normal, Capacity.Low};
+            for (std::size_t i = 0; i < QueueLaneCount; ++i) {
+                Lanes[i].Items.reserve(Lanes[i].Head + Sizes[i]);
+            }
+        }
+
+        /// Сколько элементов полосы помещаются без перевыделения.
+        TQueueLaneSizes GetCapacity() const {
+            std::lock_guard lock(Mutex);
+            auto Free = [](const TLane& Lane) {
+                return Lane.Items.capacity() - Lane.Head;
+            };
+            return {Free(Lanes[0]), Free(Lanes[1]), Free(Lanes[2])};
+        }
+
+        /// Наибольшая глубина каждой полосы за время жизни очереди.
+        TQueueLaneSizes GetPeakDepth() const {
+            std::lock_guard lock(Mutex);
+            return {Lanes[0].Peak, Lanes[1].Peak, Lanes[2].Peak};
+        }
+
+        /// Задать веса полос. Бросает std::invalid_argument на нулевой вес.
+        void SetWeights(const TQueueWeights& WeightsV) {
+            if (WeightsV.High == 0 || WeightsV.Normal == 0 || WeightsV.Low == 0 || WeightsV.Deadline == 0) {
+                throw std::invalid_argument("queue lane weights must be positive");
+            }
+
+            std::lock_guard lock(Mutex);
+            Weights = {WeightsV.High, WeightsV.Normal, WeightsV.Low};
+            Credits = Weights;
+            DeadlineWeight = WeightsV.Deadline;
+            DeadlineCredit = DeadlineWeight;
+        }
+
+        /// eventfd очереди (-1 вне Linux).
+        int GetWakeupFd() const {
+            return WakeupFd;
+        }
+
+    private:
+        /// Ожидающие элементы полосы — [Head, Items.size()). Вектор вместо
+        /// deque, чтобы ёмкость можно было зарезервировать и переиспользовать.
+        struct TLane {
+            std::vector<TQueuedItem> Items;
+            std::size_t Head = 0;
+            /// Наибольшая наблюдённая глубина (для профиля ёмкости).
+            std::size_t Peak = 0;
+
+            std::size_t Size() const noexcept {
+                return Items.size() - Head;
+            }
+        };
+
+        /// Выборка пакета для DrainReady.
+        void TakeBatchUnlocked(std::vector<TQueuedItem>& Batch,
+                               std::vector<TQueuedItem>& Expired,
+                               std::size_t MaxBatch) {
+            TakeUnlocked(Batch, Expired, MaxBatch);
+            if (Pending == 0 && Deadlines.Empty()) {
+                ClearSignalUnlocked();
+            }
+        }
+
+        /// Обработать просроченные элементы. Если обработчик TExpired
+        /// бросил исключение, остальные просроченные удаляются,
+        /// а ещё не доставленный пакет возвращается в очередь.
+        void RunExpired(std::vector<TQueuedItem>& Expired, std::vector<TQueuedItem>& Batch) {
+            for (std::size_t i = 0; i < Expired.size(); ++i) {
+                try {
+                    auto* Handle = Expired[i].Expire ? Expired[i].Expire : Expired[i].Drop;
+                    Handle(Expired[i].Payload, Expired[i].Context);
+                } catch (...) {
+                    for (++i; i < Expired.size(); ++i) {
+                        Expired[i].Drop(Expired[i].Payload, Expired[i].Context);
+                    }
+                    Requeue(Batch.begin(), Batch.end());
+                    throw;
+                }
+            }
+        }
+
+        /// Ожидаемое время доставки события типа Type (0, пока тип не встречался).
+        std::chrono::nanoseconds PredictCost(TTypeId Type) const {
+            std::lock_guard lock(Mutex);
+            return std::chrono::nanoseconds(Type < CostByType.size() ? std::max<std::int64_t>(CostByType[Type], 0) : 0);
+        }
+
+        /// Скользящее среднее с весом 1/8 для нового замера.
+        void NoteCost(TTypeId Type, std::chrono::nanoseconds Sample) {
+            const auto Value = static_cast<std::int64_t>(Sample.count());
+            std::lock_guard lock(Mutex);
+            if (CostByType.size() <= Type) {
+                CostByType.resize(static_cast<std::size_t>(Type) + 1, -1);
+            }
+
+            auto& Cost = CostByType[Type];
+            Cost = Cost < 0 ? Value : Cost + (Value - Cost) / 8;
+        }
+
+        /// Набрать до Count элементов по ближайшему дедлайну. Просроченные
+        /// уходят в Expired и в Count не считаются. Возвращает, сколько
+        /// элементов попало в Batch.
+        std::size_t TakeDeadlinesUnlocked(std::vector<TQueuedItem>& Batch,
+                                          std::vector<TQueuedItem>& Expired,
+                                          TQueuedItem::TTimePoint Now,
+                                          std::size_t Count) {
+            std::size_t Taken = 0;
+            while (!Deadlines.Empty() && Taken < Count) {
+                TQueuedItem::TTimePoint Deadline;
+                const auto Item = Deadlines.Pop(Deadline);
+                if (Deadline < Now) {
+                    Expired.push_back(Item);
+                } else {
+                    Batch.push_back(Item);
+                    ++Taken;
+                }
+            }
+            return Taken;
+        }
+
+        /// Добрать пакет до Limit элементов по весам: очередь дедлайнов и полосы.
+        /// Кредит участника тратится на каждый выданный элемент; когда ни у
+        /// одного непустого участника кредита не осталось, начинается новый
+        /// круг. Просроченные элементы уходят в Expired и кредита не тратят.
+        void TakeUnlocked(std::vector<TQueuedItem>& Batch,
+                          std::vector<TQueuedItem>& Expired,
+                          std::size_t Limit) {
+            const auto Now = Deadlines.Empty() ? TQueuedItem::TTimePoint{} : std::chrono::steady_clock::now();
+            Batch.reserve(Batch.size() + std::min(Limit - Batch.size(), Pending + Deadlines.Size()));
+            while (Batch.size() < Limit) {
+                while (!Deadlines.Empty() && Deadlines.Top() < Now) {
+                    TQueuedItem::TTimePoint Deadline;
+                    Expired.push_back(Deadlines.Pop(Deadline));
+                }
+
+                const bool Timed = !Deadlines.Empty();
+                std::size_t Index = QueueLaneCount;
+                std::size_t NonEmpty = Timed ? 1 : 0;
+                for (std::size_t i = 0; i < QueueLaneCount; ++i) {
+                    if (Lanes[i].Size() == 0) {
+                        continue;
+                    }
+                    ++NonEmpty;
+                    if (Index == QueueLaneCount && Credits[i] > 0) {
+                        Index = i;
+                    }
+                }
+
+                if (NonEmpty == 0) {
+                    return;
+                }
+
+                if (Timed && DeadlineCredit > 0) {
+                    std::size_t Take = Limit - Batch.size();
+                    if (NonEmpty > 1) {
+                        Take = std::min<std::size_t>(Take, DeadlineCredit);
+                    }
+                    const std::size_t Taken = TakeDeadlinesUnlocked(Batch, Expired, Now, Take);
+                    if (NonEmpty > 1) {
+                        DeadlineCredit -= static_cast<std::uint32_t>(Taken);
+                    }
+                    continue;
+                }
+
+                if (Index == QueueLaneCount) {
+                    Credits = Weights;
+                    DeadlineCredit = DeadlineWeight;
+                    continue;
+                }
+
+                auto& Lane = Lanes[Index];
+                std::size_t Take = std::min(Lane.Size(), Limit - Batch.size());
+                if (NonEmpty > 1) {
+                    Take = std::min<std::size_t>(Take, Credits[Index]);
+                    Credits[Index] -= static_cast<std::uint32_t>(Take);
+                }
+
+                const auto First = Lane.Items.begin() + static_cast<std::ptrdiff_t>(Lane.Head);
+                Batch.insert(Batch.end(), First, First + static_cast<std::ptrdiff_t>(Take));
+                Lane.Head += Take;
+                Pending -= Take;
+
+                if (Lane.Head == Lane.Items.size()) {
+                    // clear() сохраняет ёмкость: в устоявшемся режиме Push не аллоцирует.
+                    Lane.Items.clear();
+                    Lane.Head = 0;
+                } else if (Lane.Head * 2 > Lane.Items.size()) {
+                    Lane.Items.erase(Lane.Items.begin(), Lane.Items.begin() + static_cast<std::ptrdiff_t>(Lane.Head));
+                    Lane.Head = 0;
+                }
+            }
+        }
+
+        /// Устойчивая сортировка пакета по плотному id типа.
+        /// Обычно id в пакете лежат в узком диапазоне — тогда хватает
+        /// одного прохода подсчётом; иначе откатываемся на stable_sort.
+        static void GroupByType(std::vector<TQueuedItem>& Batch) {
+            if (Batch.size() < 2) {
+                return;
+            }
+
+            const auto [MinIt, MaxIt] = std::minmax_element(
+                Batch.begin(), Batch.end(),
+                [](const TQueuedItem& a, const TQueuedItem& b) { return a.Type < b.Type; });
+            const TTypeId Min = MinIt->Type;
+            const std::size_t Range = static_cast<std::size_t>(MaxIt->Type - Min) + 1;
+            if (Range == 1) {
+                return;
+            }
+
+            if (Range > Batch.size() * 4 + 64) {
+                std::stable_sort(Batch.begin(), Batch.end(),
+                                 [](const TQueuedItem& a, const TQueuedItem& b) { return a.Type < b.Type; });
+                return;
+            }
+
+            std::vector<std::size_t> Offsets(Range + 1, 0);
+            for (const auto& Item : Batch) {
+                ++Offsets[Item.Type - Min + 1];
+            }
+            for (std::size_t i = 1; i <= Range; ++i) {
+                Offsets[i] += Offsets[i - 1];
+            }
+
+            std::vector<TQueuedItem> Sorted(Batch.size());
+            for (const auto& Item : Batch) {
+                Sorted[Offsets[Item.Type - Min]++] = Item;
+            }
+            Batch.swap(Sorted);
+        }
+
+        /// Доставка отсортированного пакета: каждая группа одного типа
+        /// уходит в RunBatch целиком, если он задан.
+        void RunGrouped(std::vector<TQueuedItem>& Batch) {
+            std::size_t First = 0;
+            while (First < Batch.size()) {
+                std::size_t Last = First + 1;
+                while (Last < Batch.size() && Batch[Last].Type == Batch[First].Type) {
+                    ++Last;
+                }
+
+                std::size_t Done = 0;
+                try {
+                    if (Batch[First].RunBatch) {
+                        Batch[First].RunBatch(&Batch[First], Last - First, Done);
+                    } else {
+                        for (; First + Done < Last;) {
+                            const auto& Item = Batch[First + Done++];
+                            Item.Run(Item.Payload, Item.Context);
+                        }
+                    }
+                } catch (...) {
+                    Requeue(Batch.begin() + static_cast<std::ptrdiff_t>(First + Done), Batch.end());
+                    throw;
+                }
+                First = Last;
+            }
+        }
+
+        /// Вернуть невыполненный остаток пакета в головы его полос. Кредит
+        /// круга, потраченный на эти элементы, возвращается (не выше веса):
+        /// отложенное бюджетом событие не отнимает у полосы её долю.
+        void Requeue(std::vector<TQueuedItem>::iterator First,
+                     std::vector<TQueuedItem>::iterator Last) {
+            if (First == Last) {
+                return;
+            }
+
+            std::array<std::vector<TQueuedItem>, QueueLaneCount> Rest;
+            std::vector<TQueuedItem> Timed;
+            for (auto it = First; it != Last; ++it) {
+                (it->Deadline != TQueuedItem::NoDeadline ? Timed : Rest[it->Lane]).push_back(*it);
+            }
+
+            bool WasEmpty = false;
+            {
+                std::lock_guard lock(Mutex);
+                WasEmpty = Pending == 0 && Deadlines.Empty();
+
+                for (const auto& Item : Timed) {
+                    Deadlines.Push(Item.Deadline, Item);
+                }
+                DeadlineCredit = static_cast<std::uint32_t>(std::min<std::size_t>(DeadlineWeight, DeadlineCredit + Timed.size()));
+
+                for (std::size_t i = 0; i < QueueLaneCount; ++i) {
+                    auto& Lane = Lanes[i];
+                    const std::size_t Count = Rest[i].size();
+                    if (Lane.Head >= Count) {
+                        Lane.Head -= Count;
+                        std::copy(Rest[i].begin(), Rest[i].end(), Lane.Items.begin() + static_cast<std::ptrdiff_t>(Lane.Head));
+                    } else {
+                        Lane.Items.insert(Lane.Items.begin() + static_cast<std::ptrdiff_t>(Lane.Head), Rest[i].begin(), Rest[i].end());
+                    }
+                    Pending += Count;
+                    Credits[i] = static_cast<std::uint32_t>(std::min<std::size_t>(Weights[i], Credits[i] + Count));
+                }
+                if (WasEmpty) {
+                    SignalUnlocked();
+                }
+            }
+
+            if (WasEmpty) {
+                WaitPoint.Notify();
+            }
+        }
+
+        /// Запись в eventfd идёт под Mutex вместе с флагом Signaled, так что
+        /// выборка не пропустит запись, сделанную после её проверки.
+        void SignalUnlocked() {
+#if defined(__linux__)
+            const std::uint64_t One = 1;
+            while (::write(WakeupFd, &One, sizeof(One)) < 0 && errno == EINTR) {
+            }
+#endif
+            Signaled = true;
+        }
+
+        /// Сбросить дескриптор; read() — только если в него писали.
+        /// Если сигнальные очереди отмечены и ещё не разобраны, read() мог
+        /// забрать и запись обработчика сигнала — дескриптор взводится снова.
+        void ClearSignalUnlocked() {
+            if (!Signaled) {
+                return;
+            }
+#if defined(__linux__)
+            std::uint64_t Value = 0;
+            while (::read(WakeupFd, &Value, sizeof(Value)) < 0 && errno == EINTR) {
+            }
+#endif
+            Signaled = false;
+            if (SignalSourcePending.load(std::memory_order_acquire)) {
+                SignalUnlocked();
+            }
+        }
+
+        // --------- Данные ---------
+
+        mutable std::mutex Mutex;
+        std::array<TLane, QueueLaneCount> Lanes;
+        std::size_t Pending = 0;
+        std::array<std::uint32_t, QueueLaneCount> Weights{8, 4, 1};
+        /// Остаток веса полос в текущем круге.
+        std::array<std::uint32_t, QueueLaneCount> Credits{8, 4, 1};
+        TDeadlineQueue<TQueuedItem> Deadlines;
+        /// Вес и остаток доли очереди дедлайнов в круге.
+        std::uint32_t DeadlineWeight = 8;
+        std::uint32_t DeadlineCredit = 8;
+        /// Скользящее среднее времени доставки по плотному id типа, нс
+        /// (-1 — замеров ещё не было).
+        std::vector<std::int64_t> CostByType;
+        int WakeupFd = -1;
+        /// В eventfd записано и ещё не вычитано (под Mutex).
+        bool Signaled = false;
+        /// В сигнальные очереди EventSystem поставлены события, которые ещё
+        /// не разобраны; ставится из обработчика сигнала, поэтому атомарный.
+        std::atomic<bool> SignalSourcePending{false};
+
+        TWaitPoint WaitPoint;
+        std::atomic<bool> Interrupted{false};
+    };
+
+} // namespace NEventSystem::NInternal
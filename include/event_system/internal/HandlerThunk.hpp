@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace NEventSystem::NInternal {
+
+    /// Как событие передаётся в обработчик: маленькие trivially copyable
+    /// события — по значению (в регистрах), остальные — по константной ссылке.
+    template <typename TEvent>
+    inline constexpr bool PassEventByValue =
+        std::is_trivially_copyable_v<TEvent> && sizeof(TEvent) <= 2 * sizeof(void*);
+
+    template <typename TEvent>
+    using TEventArg = std::conditional_t<PassEventByValue<TEvent>, TEvent, const TEvent&>;
+
+    /// Type-erased обработчик с сигнатурой вызова void(TArg).
+    /// В отличие от std::function, аргумент доходит до вызываемого объекта
+    /// без промежуточной ссылки, так что TArg по значению остаётся в регистрах.
+    /// Маленькие trivially copyable объекты (лямбды с захватом по ссылке)
+    /// хранятся внутри без аллокации.
+    template <typename TArg>
+    class THandlerThunk {
+    public:
+        THandlerThunk() = default;
+
+        template <typename TFunc>
+            requires(!std::is_same_v<std::remove_cvref_t<TFunc>, THandlerThunk>)
+        THandlerThunk(TFunc&& Func) {
+            // decay: ссылка на функцию хранится как указатель на неё.
+            using TStored = std::decay_t<TFunc>;
+
+            if constexpr (IsInline<TStored>) {
+                ::new (static_cast<void*>(Storage)) TStored(std::forward<TFunc>(Func));
+                Object = Storage;
+            } else {
+                Object = new TStored(std::forward<TFunc>(Func));
+                Destroy = &DestroyImpl<TStored>;
+            }
+            Invoke = &InvokeImpl<TStored>;
+        }
+
+        THandlerThunk(THandlerThunk&& other) noexcept {
+            MoveFrom(other);
+        }
+
+        THandlerThunk& operator=(THandlerThunk&& other) noexcept {
+            if (this != &other) {
+                Reset();
+                MoveFrom(other);
+            }
+            return *this;
+        }
+
+        THandlerThunk(const THandlerThunk&) = delete;
+        THandlerThunk& operator=(const THandlerThunk&) = delete;
+
+        ~THandlerThunk() {
+            Reset();
+        }
+
+        void operator()(TArg Arg) const {
+            Invoke(Object, Arg);
+        }
+
+        explicit operator bool() const noexcept {
+            return Invoke != nullptr;
+        }
+
+    private:
+        static constexpr std::size_t InlineSize = 2 * sizeof(void*);
+
+        template <typename TStored>
+        static constexpr bool IsInline =
+            std::is_trivially_copyable_v<TStored> && sizeof(TStored) <= InlineSize &&
+            alignof(TStored) <= alignof(void*);
+
+        template <typename TStored>
+        static void InvokeImpl(void* Obj, TArg Arg) {
+            (*static_cast<TStored*>(Obj))(Arg);
+        }
+
+        template <typename TStored>
+        static void DestroyImpl(void* Obj) {
+            delete static_cast<TStored*>(Obj);
+        }
+
+        void MoveFrom(THandlerThunk& other) noexcept {
+            Invoke = other.Invoke;
+            Destroy = other.Destroy;
+            if (other.Object == other.Storage) {
+                std::memcpy(Storage, other.Storage, InlineSize);
+                Object = Storage;
+            } else {
+                Object = other.Object;
+            }
+            other.Object = nullptr;
+            other.Invoke = nullptr;
+            other.Destroy = nullptr;
+        }
+
+        void Reset() noexcept {
+            if (Destroy) {
+                Destroy(Object);
+            }
+            Object = nullptr;
+            Invoke = nullptr;
+            Destroy = nullptr;
+        }
+
+        void* Object = nullptr;
+        void (*Invoke)(void*, TArg) = nullptr;
+        void (*Destroy)(void*) = nullptr;
+        alignas(void*) unsigned char Storage[InlineSize];
+    };
+
+} // namespace NEventSystem::NInternal
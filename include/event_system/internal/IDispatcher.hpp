@@ -1,6 +1,10 @@
 #pragma once
 
+#include <compare>
 #include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 namespace NEventSystem {
 
@@ -12,8 +16,55 @@ namespace NEventSystem {
                            Normal,
                            High };
 
+    /// Числовой приоритет обработчика: больше — раньше, при равенстве —
+    /// в порядке подписки. Значения EPriority — опорные точки диапазонов
+    /// Low ≈ [-32768, -512), Normal ≈ [-512, 512), High ≈ [512, 32767],
+    /// так что подсистемы можно расставить вокруг них.
+    class TPriority {
+    public:
+        static constexpr std::int16_t LowValue = -1024;
+        static constexpr std::int16_t NormalValue = 0;
+        static constexpr std::int16_t HighValue = 1024;
+
+        constexpr TPriority(EPriority Level) noexcept
+            : Value(Level == EPriority::High  ? HighValue
+                    : Level == EPriority::Low ? LowValue
+                                              : NormalValue) {
+        }
+
+        constexpr TPriority(std::int16_t Raw) noexcept
+            : Value(Raw) {
+        }
+
+        constexpr std::int16_t Get() const noexcept {
+            return Value;
+        }
+
+        friend constexpr auto operator<=>(TPriority, TPriority) = default;
+
+    private:
+        std::int16_t Value;
+    };
+
+    /// Ограничения порядка обработчика относительно меток других обработчиков
+    /// того же события. Ограничения сильнее приоритета; ссылки на метки,
+    /// которых нет среди подписчиков, игнорируются.
+    struct TOrdering {
+        std::string Label;
+        std::vector<std::string> Before;
+        std::vector<std::string> After;
+    };
+
     namespace NInternal {
 
+        /// Пики, наблюдённые диспетчером за время жизни (для профиля ёмкости),
+        /// и текущая ёмкость списка обработчиков.
+        struct TCapacityStats {
+            std::size_t PeakHandlers = 0;
+            std::size_t PeakQueued = 0;
+            std::size_t HandlerCapacity = 0;
+        };
+
         /// Базовый интерфейс диспетчера для конкретного типа события.
         /// Нужен для type-erasure в EventSystem.
         class TIDispatcher {
@@ -24,6 +75,22 @@ namespace NEventSystem {
             /// Возвращает true, если обработчик найден.
             virtual bool Remove(THandlerId Id) = 0;
 
+            /// Приостановить (Paused = true) или возобновить обработчик.
+            /// Возвращает true, если обработчик найден.
+            virtual bool SetPaused(THandlerId Id, bool Paused) = 0;
+
+            /// Переставить обработчик по новому приоритету.
+            /// Возвращает true, если обработчик найден.
+            virtual bool SetPriority(THandlerId Id, TPriority Priority) = 0;
+
+            /// Снять все подписки (без идущих Dispatch этого типа).
+            virtual void Clear() = 0;
+
+            /// Заранее выделить место под ExpectedHandlers обработчиков.
+            virtual void Reserve(std::size_t ExpectedHandlers) = 0;
+
+            [[nodiscard]] virtual TCapacityStats GetCapacityStats() const = 0;
+
             /// Количество активных обработчиков.
             [[nodiscard]] virtual std::size_t Count() const = 0;
         };
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace NEventSystem::NInternal {
+
+    /// Пул неизменяемых блоков с событием для асинхронной рассылки.
+    /// Событие кладётся в блок один раз; каждая очередь-получатель держит
+    /// только указатель. Счётчик ссылок интрузивный и задаётся сразу
+    /// по числу получателей, блок возвращается в пул последним Release.
+    ///
+    /// Занятый блок держит владельца пула (Owner), так что пул переживает
+    /// очереди исполнителей, в которых ещё лежат его блоки.
+    template <typename TEvent>
+    class TSharedEventPool {
+    public:
+        static constexpr std::size_t MaxCachedBlocks = 256;
+
+        struct TBlock {
+            std::atomic<std::uint32_t> Refs{0};
+            TSharedEventPool* Pool = nullptr;
+            /// Владелец пула; пуст, пока блок свободен.
+            std::shared_ptr<void> Owner;
+            alignas(TEvent) unsigned char Storage[sizeof(TEvent)];
+
+            const TEvent& Event() const {
+                return *std::launder(reinterpret_cast<const TEvent*>(Storage));
+            }
+        };
+
+        TSharedEventPool() = default;
+
+        ~TSharedEventPool() {
+            for (auto* Block : Free) {
+                delete Block;
+            }
+        }
+
+        TSharedEventPool(const TSharedEventPool&) = delete;
+        TSharedEventPool& operator=(const TSharedEventPool&) = delete;
+
+        /// Взять блок и скопировать в него событие. Refs — число получателей.
+        TBlock* Acquire(std::uint32_t Refs, std::shared_ptr<void> Owner, const TEvent& Event) {
+            TBlock* Block = nullptr;
+            {
+                std::lock_guard lock(Mutex);
+                if (!Free.empty()) {
+                    Block = Free.back();
+                    Free.pop_back();
+                }
+            }
+
+            if (!Block) {
+                Block = new TBlock();
+            }
+
+            try {
+                ::new (static_cast<void*>(Block->Storage)) TEvent(Event);
+            } catch (...) {
+                Recycle(Block);
+                throw;
+            }
+
+            Block->Pool = this;
+            Block->Owner = std::move(Owner);
+            Block->Refs.store(Refs, std::memory_order_relaxed);
+            return Block;
+        }
+
+        /// Отпустить ссылку; последняя разрушает событие и возвращает блок в пул.
+        static void Release(TBlock* Block) {
+            if (Block->Refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                return;
+            }
+
+            std::launder(reinterpret_cast<TEvent*>(Block->Storage))->~TEvent();
+            // Владельца отпускаем после возврата блока: он может быть
+            // последней ссылкой на сам пул.
+            const auto Owner = std::move(Block->Owner);
+            Block->Pool->Recycle(Block);
+        }
+
+    private:
+        void Recycle(TBlock* Block) {
+            {
+                std::lock_guard lock(Mutex);
+                if (Free.size() < MaxCachedBlocks) {
+                    Free.push_back(Block);
+                    return;
+                }
+            }
+            delete Block;
+        }
+
+        std::mutex Mutex;
+        std::vector<TBlock*> Free;
+    };
+
+} // namespace NEventSystem::NInternal
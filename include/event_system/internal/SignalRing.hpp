@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+#include "TypeId.hpp"
+
+namespace NEventSystem::NInternal {
+
+    /// Ограниченная lock-free очередь trivially copyable событий (схема Вьюкова).
+    /// TryPush можно вызывать из обработчика сигнала: память выделена заранее,
+    /// нет блокировок и системных вызовов.
+    template <typename TEvent>
+    class TSignalRing {
+        static_assert(std::is_trivially_copyable_v<TEvent>);
+        static_assert(std::atomic<std::size_t>::is_always_lock_free);
+
+    public:
+        explicit TSignalRing(std::size_t Capacity)
+            : Mask(std::bit_ceil(Capacity < 2 ? std::size_t{2} : Capacity) - 1)
+            , Cells(std::make_unique<TCell[]>(Mask + 1)) {
+            for (std::size_t i = 0; i <= Mask; ++i) {
+                Cells[i].Sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        /// Положить событие. false — очередь заполнена.
+        bool TryPush(const TEvent& Event) noexcept {
+            std::size_t Pos = Tail.load(std::memory_order_relaxed);
+            TCell* Cell = nullptr;
+
+            for (;;) {
+                Cell = &Cells[Pos & Mask];
+                const std::size_t Seq = Cell->Sequence.load(std::memory_order_acquire);
+                const auto Diff = static_cast<std::intptr_t>(Seq) - static_cast<std::intptr_t>(Pos);
+
+                if (Diff == 0) {
+                    if (Tail.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (Diff < 0) {
+                    return false;
+                } else {
+                    Pos = Tail.load(std::memory_order_relaxed);
+                }
+            }
+
+            Cell->Storage = std::bit_cast<TStorage>(Event);
+            Cell->Sequence.store(Pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// Забрать событие. std::nullopt — очередь пуста
+        /// (или ближайшая ячейка ещё дописывается прерванным производителем).
+        std::optional<TEvent> TryPop() noexcept {
+            std::size_t Pos = Head.load(std::memory_order_relaxed);
+            TCell* Cell = nullptr;
+
+            for (;;) {
+                Cell = &Cells[Pos & Mask];
+                const std::size_t Seq = Cell->Sequence.load(std::memory_order_acquire);
+                const auto Diff = static_cast<std::intptr_t>(Seq) - static_cast<std::intptr_t>(Pos + 1);
+
+                if (Diff == 0) {
+                    if (Head.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (Diff < 0) {
+                    return std::nullopt;
+                } else {
+                    Pos = Head.load(std::memory_order_relaxed);
+                }
+            }
+
+            const TStorage Storage = Cell->Storage;
+            Cell->Sequence.store(Pos + Mask + 1, std::memory_order_release);
+            return std::bit_cast<TEvent>(Storage);
+        }
+
+        std::size_t Capacity() const {
+            return Mask + 1;
+        }
+
+    private:
+        using TStorage = std::array<std::byte, sizeof(TEvent)>;
+
+        struct TCell {
+            std::atomic<std::size_t> Sequence{0};
+            TStorage Storage{};
+        };
+
+        const std::size_t Mask;
+        std::unique_ptr<TCell[]> Cells;
+
+        alignas(64) std::atomic<std::size_t> Head{0};
+        alignas(64) std::atomic<std::size_t> Tail{0};
+    };
+
+    /// Базовый интерфейс сигнальной очереди конкретного типа события.
+    /// Очереди образуют односвязный список, который можно обходить
+    /// из обработчика сигнала.
+    class TSignalQueueBase {
+    public:
+        explicit TSignalQueueBase(TTypeId typeId)
+            : TypeId(typeId) {
+        }
+
+        virtual ~TSignalQueueBase() = default;
+
+        /// Доставить накопленные события. Возвращает их количество.
+        virtual std::size_t Drain() = 0;
+
+        const TTypeId TypeId;
+        TSignalQueueBase* Next = nullptr;
+    };
+
+} // namespace NEventSystem::NInternal
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "IDispatcher.hpp"
+
+namespace NEventSystem {
+
+    /// Точка на плоскости мира.
+    struct TPoint {
+        float X = 0.0f;
+        float Y = 0.0f;
+    };
+
+    /// Область интереса подписчика: прямоугольник [Min, Max] по осям.
+    struct TRegion {
+        float MinX = 0.0f;
+        float MinY = 0.0f;
+        float MaxX = 0.0f;
+        float MaxY = 0.0f;
+
+        bool Contains(TPoint Point) const noexcept {
+            return Point.X >= MinX && Point.X <= MaxX && Point.Y >= MinY && Point.Y <= MaxY;
+        }
+    };
+
+    /// Трейт позиции события для SubscribeInRegion. Специализация задаёт
+    ///     static TPoint Get(const TEvent&);
+    /// и, по желанию, размер ячейки сетки:
+    ///     static constexpr float CellSize = ...;
+    template <typename TEvent>
+    struct TPositionOf;
+
+    template <typename T>
+    concept PositionalEvent = requires(const T& Event) {
+        { TPositionOf<T>::Get(Event) } -> std::convertible_to<TPoint>;
+    };
+
+    namespace NInternal {
+
+        template <typename TEvent>
+        constexpr float CellSizeOf() {
+            if constexpr (requires { TPositionOf<TEvent>::CellSize; }) {
+                return TPositionOf<TEvent>::CellSize;
+            } else {
+                return 64.0f;
+            }
+        }
+
+        /// Равномерная сетка подписок по областям интереса. Подписка лежит
+        /// в каждой ячейке, которую накрывает её область, так что событие
+        /// смотрит ровно одну ячейку (поиск в хеш-таблице) и проверяет только
+        /// её подписчиков. Области шире MaxCellsPerRegion ячеек лежат
+        /// в отдельном списке Wide и проверяются на каждом событии.
+        /// В ячейке подписки упорядочены по приоритету.
+        ///
+        /// Сетка меняется на месте под собственной блокировкой: смена области
+        /// (MoveRegion) не пересобирает таблицу диспетчера и трогает только
+        /// ячейки, которые область покинула или заняла.
+        template <typename TSlot>
+        class TSpatialGrid {
+        public:
+            using TSlotPtr = std::shared_ptr<TSlot>;
+
+            static constexpr std::size_t MaxCellsPerRegion = 1024;
+
+            explicit TSpatialGrid(float cellSize)
+                : CellSize(cellSize) {
+                if (!(CellSize > 0.0f)) {
+                    throw std::invalid_argument("spatial grid cell size must be positive");
+                }
+            }
+
+            /// Бросает std::invalid_argument на нечисловую или бесконечную
+            /// границу области; сетка при этом не меняется.
+            void Insert(TSlotPtr Slot, const TRegion& Region) {
+                CheckFinite(Region);
+                std::unique_lock lock(Mutex);
+                const auto Cells = CellsOf(Region);
+                ForEachCell(Cells, [&](std::uint64_t Key) {
+                    InsertByPriority(Bucket(Key), {Slot, Region});
+                });
+                Regions.emplace(Slot->Id, TRecord{Slot, Region, Cells});
+            }
+
+            bool Move(THandlerId Id, const TRegion& Region) {
+                CheckFinite(Region);
+                std::unique_lock lock(Mutex);
+                auto it = Regions.find(Id);
+                if (it == Regions.end()) {
+                    return false;
+                }
+
+                auto& Record = it->second;
+                const auto Old = Record.Cells;
+                const auto New = CellsOf(Region);
+                ForEachCell(Old, [&](std::uint64_t Key) {
+                    if (!New.Covers(Key)) {
+                        EraseFrom(Key, Id);
+                    }
+                });
+                ForEachCell(New, [&](std::uint64_t Key) {
+                    if (Old.Covers(Key)) {
+                        auto& Entries = Bucket(Key);
+                        std::find_if(Entries.begin(), Entries.end(), [Id](const TEntry& Entry) {
+                            return Entry.Slot->Id == Id;
+                        })->Region = Region;
+                    } else {
+                        InsertByPriority(Bucket(Key), {Record.Slot, Region});
+                    }
+                });
+
+                Record.Region = Region;
+                Record.Cells = New;
+                return true;
+            }
+
+            /// Убрать подписку; возвращает её слот (nullptr, если не найдена).
+            TSlotPtr Remove(THandlerId Id) {
+                std::unique_lock lock(Mutex);
+                auto it = Regions.find(Id);
+                if (it == Regions.end()) {
+                    return nullptr;
+                }
+
+                ForEachCell(it->second.Cells, [&](std::uint64_t Key) {
+                    EraseFrom(Key, Id);
+                });
+                auto Slot = std::move(it->second.Slot);
+                Regions.erase(it);
+                return Slot;
+            }
+
+            TSlotPtr Find(THandlerId Id) const {
+                std::shared_lock lock(Mutex);
+                auto it = Regions.find(Id);
+                return it == Regions.end() ? nullptr : it->second.Slot;
+            }
+
+            /// Дописать в конец Out подписчиков, чья область содержит Point,
+            /// в порядке приоритета; прежнее содержимое Out не трогается.
+            /// Слоты копируются, чтобы обработчики вызывались без блокировки
+            /// сетки и могли сами менять области. Точка с нечисловой или
+            /// бесконечной координатой не попадает ни в одну область.
+            void Collect(TPoint Point, std::vector<TSlotPtr>& Out) const {
+                if (!std::isfinite(Point.X) || !std::isfinite(Point.Y)) {
+                    return;
+                }
+
+                std::shared_lock lock(Mutex);
+                const std::size_t First = Out.size();
+                if (auto it = Grid.find(Key(Cell(Point.X), Cell(Point.Y))); it != Grid.end()) {
+                    for (const auto& Entry : it->second) {
+                        if (Entry.Region.Contains(Point)) {
+                            Out.push_back(Entry.Slot);
+                        }
+                    }
+                }
+
+                const auto WideCount = static_cast<std::size_t>(std::ranges::count_if(Wide, [Point](const TEntry& Entry) {
+                    return Entry.Region.Contains(Point);
+                }));
+                if (WideCount == 0) {
+                    return;
+                }
+
+                // Обе серии уже упорядочены по приоритету: сливаем их с конца
+                // прямо в Out, без сортировки и временного буфера. При равном
+                // приоритете подписка ячейки остаётся раньше подписки из Wide.
+                std::size_t CellEnd = Out.size();
+                Out.resize(CellEnd + WideCount);
+                std::size_t Write = Out.size();
+                for (auto it = Wide.rbegin(); Write != CellEnd; ++it) {
+                    if (!it->Region.Contains(Point)) {
+                        continue;
+                    }
+                    while (CellEnd > First && Out[CellEnd - 1]->Priority < it->Slot->Priority) {
+                        Out[--Write] = std::move(Out[--CellEnd]);
+                    }
+                    Out[--Write] = it->Slot;
+                }
+            }
+
+            template <typename TFunc>
+            void ForEachSlot(TFunc&& Func) const {
+                std::shared_lock lock(Mutex);
+                for (const auto& [_, Record] : Regions) {
+                    Func(Record.Slot);
+                }
+            }
+
+            std::vector<TSlotPtr> Clear() {
+                std::unique_lock lock(Mutex);
+                std::vector<TSlotPtr> Slots;
+                Slots.reserve(Regions.size());
+                for (auto& [_, Record] : Regions) {
+                    Slots.push_back(std::move(Record.Slot));
+                }
+                Regions.clear();
+                Grid.clear();
+                Wide.clear();
+                return Slots;
+            }
+
+        private:
+            struct TEntry {
+                TSlotPtr Slot;
+                TRegion Region;
+            };
+
+            /// Диапазон ячеек области; Wide — область в сетку не раскладывается.
+            struct TCellRange {
+                std::int32_t MinX = 0;
+                std::int32_t MinY = 0;
+                std::int32_t MaxX = -1;
+                std::int32_t MaxY = -1;
+                bool Wide = false;
+
+                bool Covers(std::uint64_t CellKey) const noexcept {
+                    if (Wide) {
+                        return CellKey == WideKey;
+                    }
+                    const auto X = static_cast<std::int32_t>(static_cast<std::uint32_t>(CellKey >> 32));
+                    const auto Y = static_cast<std::int32_t>(static_cast<std::uint32_t>(CellKey));
+                    return X >= MinX && X <= MaxX && Y >= MinY && Y <= MaxY;
+                }
+            };
+
+            struct TRecord {
+                TSlotPtr Slot;
+                TRegion Region;
+                TCellRange Cells;
+            };
+
+            /// Ключ списка Wide. Координаты ячеек ограничены ±CellLimit,
+            /// так что с настоящей ячейкой он не совпадает.
+            static constexpr std::int32_t CellLimit = 1'000'000'000;
+            static constexpr std::uint64_t WideKey = std::uint64_t{0x80000000u} << 32 | 0x80000000u;
+
+            /// Coord конечна: нечисловые точки и области отсекаются раньше.
+            std::int32_t Cell(float Coord) const noexcept {
+                constexpr auto Limit = static_cast<float>(CellLimit);
+                return static_cast<std::int32_t>(std::floor(std::clamp(Coord / CellSize, -Limit, Limit)));
+            }
+
+            static void CheckFinite(const TRegion& Region) {
+                if (!std::isfinite(Region.MinX) || !std::isfinite(Region.MinY) || !std::isfinite(Region.MaxX) ||
+                    !std::isfinite(Region.MaxY)) {
+                    throw std::invalid_argument("spatial region bounds must be finite");
+                }
+            }
+
+            static std::uint64_t Key(std::int32_t X, std::int32_t Y) noexcept {
+                return (std::uint64_t{static_cast<std::uint32_t>(X)} << 32) | static_cast<std::uint32_t>(Y);
+            }
+
+            TCellRange CellsOf(const TRegion& Region) const {
+                TCellRange Range{Cell(Region.MinX), Cell(Region.MinY), Cell(Region.MaxX), Cell(Region.MaxY)};
+                const auto Width = std::int64_t{Range.MaxX} - Range.MinX + 1;
+                const auto Height = std::int64_t{Range.MaxY} - Range.MinY + 1;
+                Range.Wide = Width > 0 && Height > 0 &&
+                             static_cast<std::uint64_t>(Width) * static_cast<std::uint64_t>(Height) > MaxCellsPerRegion;
+                return Range;
+            }
+
+            template <typename TFunc>
+            static void ForEachCell(const TCellRange& Range, TFunc&& Func) {
+                if (Range.Wide) {
+                    Func(WideKey);
+                    return;
+                }
+                for (std::int32_t X = Range.MinX; X <= Range.MaxX; ++X) {
+                    for (std::int32_t Y = Range.MinY; Y <= Range.MaxY; ++Y) {
+                        Func(Key(X, Y));
+                    }
+                }
+            }
+
+            std::vector<TEntry>& Bucket(std::uint64_t CellKey) {
+                return CellKey == WideKey ? Wide : Grid[CellKey];
+            }
+
+            void EraseFrom(std::uint64_t CellKey, THandlerId Id) {
+                auto& Entries = Bucket(CellKey);
+                std::erase_if(Entries, [Id](const TEntry& Entry) { return Entry.Slot->Id == Id; });
+                if (Entries.empty() && CellKey != WideKey) {
+                    Grid.erase(CellKey);
+                }
+            }
+
+            void InsertByPriority(std::vector<TEntry>& Entries, TEntry Entry) {
+                auto pos = std::partition_point(Entries.begin(), Entries.end(), [&Entry](const TEntry& other) {
+                    return other.Slot->Priority >= Entry.Slot->Priority;
+                });
+                Entries.insert(pos, std::move(Entry));
+            }
+
+            float CellSize;
+            mutable std::shared_mutex Mutex;
+            std::unordered_map<std::uint64_t, std::vector<TEntry>> Grid;
+            std::vector<TEntry> Wide;
+            std::unordered_map<THandlerId, TRecord> Regions;
+        };
+
+    } // namespace NInternal
+} // namespace NEventSystem
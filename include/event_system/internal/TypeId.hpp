@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace NEventSystem::NInternal {
+
+    /// Плотный идентификатор типа события: 0, 1, 2, ... в порядке первого обращения.
+    using TTypeId = std::uint32_t;
+
+    /// Предел плотных id на процесс: типы событий и строковые топики
+    /// делят одно пространство [0, MaxDenseIds), по нему же рассчитана
+    /// таблица диспетчеров (TDenseDirectory).
+    inline constexpr std::size_t MaxDenseIds = std::size_t{1} << 16;
+
+    inline std::atomic<TTypeId> NextTypeId{0};
+
+    /// Идентификатор типа T. После первого вызова — одна загрузка без блокировок.
+    template <typename T>
+    TTypeId TypeIdOf() {
+        static const TTypeId Id = NextTypeId.fetch_add(1, std::memory_order_relaxed);
+        return Id;
+    }
+
+    /// Реестр строковых топиков: имя ↔ id. Id берётся из того же
+    /// пространства, что и id типов, так что топики и типы не пересекаются
+    /// и живут в одной плотной таблице диспетчеров.
+    class TTopicRegistry {
+    public:
+        static TTopicRegistry& Instance() {
+            static TTopicRegistry Registry;
+            return Registry;
+        }
+
+        /// Бросает std::length_error, если плотные id кончились (MaxDenseIds):
+        /// id при этом не расходуется, а уже выданные топики работают.
+        /// Имя с '\n' отвергается std::invalid_argument: профиль ёмкости
+        /// хранит по имени на строку.
+        TTypeId Intern(std::string_view Name) {
+            if (Name.find('\n') != std::string_view::npos) {
+                throw std::invalid_argument("topic name must not contain a line break");
+            }
+
+            std::lock_guard lock(Mutex);
+            if (auto it = Topics.find(Name); it != Topics.end()) {
+                return it->second;
+            }
+
+            TTypeId Id = NextTypeId.load(std::memory_order_relaxed);
+            do {
+                if (Id >= MaxDenseIds) {
+                    throw std::length_error("too many interned topics: dense id limit reached");
+                }
+            } while (!NextTypeId.compare_exchange_weak(Id, Id + 1, std::memory_order_relaxed));
+            auto [it, _] = Topics.emplace(std::string(Name), Id);
+            Names.emplace(Id, it->first);
+            return Id;
+        }
+
+        /// Имя топика по id; пустая строка, если id — не топик.
+        std::string_view Name(TTypeId Id) const {
+            std::lock_guard lock(Mutex);
+            auto it = Names.find(Id);
+            return it == Names.end() ? std::string_view{} : it->second;
+        }
+
+    private:
+        struct THash {
+            using is_transparent = void;
+
+            std::size_t operator()(std::string_view Value) const noexcept {
+                return std::hash<std::string_view>{}(Value);
+            }
+        };
+
+        mutable std::mutex Mutex;
+        std::unordered_map<std::string, TTypeId, THash, std::equal_to<>> Topics;
+        /// Ключи unordered_map не перемещаются, поэтому храним view на них.
+        std::unordered_map<TTypeId, std::string_view> Names;
+    };
+
+    /// Интернирование строкового топика. Строка хешируется только здесь.
+    inline TTypeId InternTopic(std::string_view Name) {
+        return TTopicRegistry::Instance().Intern(Name);
+    }
+
+} // namespace NEventSystem::NInternal
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #include <immintrin.h>
+#endif
+
+#if defined(__linux__)
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace NEventSystem {
+
+    /// Стратегия ожидания блокирующего потребителя.
+    enum class EWaitStrategy {
+        BusySpin,      ///< Чистый spin: для выделенных ядер, минимальная задержка.
+        SpinThenYield, ///< Ограниченный spin с pause, затем yield.
+        Park           ///< Короткий spin, затем сон на futex.
+    };
+
+    namespace NInternal {
+
+        inline void CpuRelax() noexcept {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+            _mm_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#endif
+        }
+
+        /// Точка ожидания потребителя: счётчик поколений и число спящих.
+        /// Производитель вызывает Notify после публикации; системный вызов
+        /// пробуждения делается, только если кто-то действительно спит.
+        class TWaitPoint {
+        public:
+            static constexpr int SpinIterations = 256;
+
+            explicit TWaitPoint(EWaitStrategy strategy = EWaitStrategy::Park)
+                : Strategy(strategy) {
+            }
+
+            void SetStrategy(EWaitStrategy strategy) noexcept {
+                Strategy.store(strategy, std::memory_order_relaxed);
+            }
+
+            EWaitStrategy GetStrategy() const noexcept {
+                return Strategy.load(std::memory_order_relaxed);
+            }
+
+            /// Текущее поколение. Снимается до проверки условия ожидания.
+            std::uint32_t Epoch() const noexcept {
+                return Generation.load(std::memory_order_seq_cst);
+            }
+
+            /// Ждать, пока поколение не сменится относительно Observed.
+            void Wait(std::uint32_t Observed) noexcept {
+                const auto Kind = GetStrategy();
+
+                if (Kind == EWaitStrategy::BusySpin) {
+                    while (Epoch() == Observed) {
+                        CpuRelax();
+                    }
+                    return;
+                }
+
+                for (int i = 0; i < SpinIterations; ++i) {
+                    if (Epoch() != Observed) {
+                        return;
+                    }
+                    CpuRelax();
+                }
+
+                if (Kind == EWaitStrategy::SpinThenYield) {
+                    while (Epoch() == Observed) {
+                        std::this_thread::yield();
+                    }
+                    return;
+                }
+
+                Waiters.fetch_add(1, std::memory_order_seq_cst);
+                while (Epoch() == Observed) {
+                    Park(Observed);
+                }
+                Waiters.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            /// Сменить поколение и разбудить спящих, если они есть.
+            /// На Linux пробуждение — голый futex, его можно вызывать из обработчика сигнала.
+            void Notify() noexcept {
+                Generation.fetch_add(1, std::memory_order_seq_cst);
+                if (Waiters.load(std::memory_order_seq_cst) != 0) {
+                    WakeAll();
+                }
+            }
+
+            /// Вариант Notify для обработчика сигнала. Вне Linux только меняет
+            /// поколение: spin-стратегии это увидят, спящий на Park — нет.
+            void NotifyFromSignal() noexcept {
+#if defined(__linux__)
+                Notify();
+#else
+                Generation.fetch_add(1, std::memory_order_seq_cst);
+#endif
+            }
+
+        private:
+            void Park(std::uint32_t Observed) noexcept {
+#if defined(__linux__)
+                ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&Generation),
+                          FUTEX_WAIT_PRIVATE, Observed, nullptr, nullptr, 0);
+#else
+                Generation.wait(Observed, std::memory_order_seq_cst);
+#endif
+            }
+
+            void WakeAll() noexcept {
+#if defined(__linux__)
+                ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&Generation),
+                          FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#else
+                Generation.notify_all();
+#endif
+            }
+
+            static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+
+            std::atomic<EWaitStrategy> Strategy;
+            std::atomic<std::uint32_t> Generation{0};
+            std::atomic<std::uint32_t> Waiters{0};
+        };
+
+    } // namespace NInternal
+} // namespace NEventSystem
@@ -0,0 +1,193 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "event_system/SocketBridge.hpp"
+
+using namespace NEventSystem;
+
+// Локальные замеры моста через socketpair: пропускная способность
+// в одну сторону (события диспетчеризуются в одной TEventSystem
+// и принимаются другой) и задержка кругового обмена ping → pong.
+
+struct TPositionEvent {
+    std::uint32_t EntityId;
+    float X;
+    float Y;
+    float Z;
+};
+
+struct TPingEvent {
+    std::uint64_t Seq;
+};
+
+struct TPongEvent {
+    std::uint64_t Seq;
+};
+
+namespace {
+
+    constexpr std::uint32_t KPositionTag = 1;
+    constexpr std::uint32_t KPingTag = 2;
+    constexpr std::uint32_t KPongTag = 3;
+    constexpr int KEvents = 1'000'000;
+    constexpr int KRoundTrips = 100'000;
+
+    struct TSocketPair {
+        int Fds[2] = {-1, -1};
+
+        TSocketPair() {
+            if (::socketpair(AF_UNIX, SOCK_SEQPACKET, 0, Fds) != 0) {
+                throw std::system_error(errno, std::generic_category(), "socketpair");
+            }
+        }
+
+        ~TSocketPair() {
+            ::close(Fds[0]);
+            ::close(Fds[1]);
+        }
+    };
+
+    void Report(const char* Name, std::chrono::steady_clock::duration Elapsed) {
+        const double Seconds = std::chrono::duration<double>(Elapsed).count();
+        std::cout << Name << ": " << KEvents << " events in " << Seconds * 1000.0
+                  << " ms (" << static_cast<long long>(KEvents / Seconds) << " events/s)\n";
+    }
+
+    // Базовая линия: один send() на событие.
+    void BenchPerEventSend() {
+        TSocketPair Pair;
+        TEventSystem Source;
+
+        Source.Subscribe<TPositionEvent>(TEventSystem::Priority::Normal, [&](const TPositionEvent& e) {
+            while (::send(Pair.Fds[0], &e, sizeof(e), 0) < 0 && errno == EINTR) {
+            }
+        });
+
+        const auto Start = std::chrono::steady_clock::now();
+
+        std::jthread Receiver([&] {
+            TEventSystem Sink;
+            int Received = 0;
+            Sink.Subscribe<TPositionEvent>(TEventSystem::Priority::Normal, [&](const TPositionEvent&) {
+                ++Received;
+            });
+
+            TPositionEvent Event{};
+            while (Received < KEvents) {
+                if (::recv(Pair.Fds[1], &Event, sizeof(Event), 0) == sizeof(Event)) {
+                    Sink.Dispatch(Event);
+                }
+            }
+        });
+
+        for (int i = 0; i < KEvents; ++i) {
+            Source.Dispatch(TPositionEvent{static_cast<std::uint32_t>(i), 1.0f, 2.0f, 3.0f});
+        }
+        Receiver.join();
+
+        Report("per-event send()", std::chrono::steady_clock::now() - Start);
+    }
+
+    void BenchBridge() {
+        TSocketPair Pair;
+        TEventSystem Source;
+        TSocketBridgeSender Sender(Source, Pair.Fds[0]);
+        Sender.Forward<TPositionEvent>(KPositionTag);
+
+        const auto Start = std::chrono::steady_clock::now();
+
+        std::jthread Receiver([&] {
+            TEventSystem Sink;
+            TSocketBridgeReceiver Bridge(Sink, Pair.Fds[1]);
+            Bridge.Route<TPositionEvent>(KPositionTag);
+
+            int Received = 0;
+            Sink.Subscribe<TPositionEvent>(TEventSystem::Priority::Normal, [&](const TPositionEvent&) {
+                ++Received;
+            });
+
+            while (Received < KEvents) {
+                Bridge.Receive();
+            }
+        });
+
+        for (int i = 0; i < KEvents; ++i) {
+            Source.Dispatch(TPositionEvent{static_cast<std::uint32_t>(i), 1.0f, 2.0f, 3.0f});
+        }
+        Sender.Flush();
+        Receiver.join();
+
+        Report("bridge (sendmmsg/recvmmsg)", std::chrono::steady_clock::now() - Start);
+    }
+
+    // Круговой обмен: на каждое событие TPingEvent вторая система отвечает
+    // TPongEvent через встречный мост того же socketpair. Следующий ping
+    // уходит только после прихода pong, так что замер — чистая задержка
+    // sendmmsg → recvmmsg → Dispatch в обе стороны.
+    void BenchRoundTrip() {
+        TSocketPair Pair;
+
+        std::jthread Echo([&] {
+            TEventSystem Remote;
+            TSocketBridgeReceiver In(Remote, Pair.Fds[1]);
+            In.Route<TPingEvent>(KPingTag);
+            TSocketBridgeSender Out(Remote, Pair.Fds[1]);
+            Out.Forward<TPongEvent>(KPongTag);
+
+            Remote.Subscribe<TPingEvent>(TEventSystem::Priority::Normal, [&](const TPingEvent& e) {
+                Remote.Dispatch(TPongEvent{e.Seq});
+            });
+
+            for (int Answered = 0; Answered < KRoundTrips;) {
+                Answered += static_cast<int>(In.Receive());
+                Out.Flush();
+            }
+        });
+
+        TEventSystem Local;
+        TSocketBridgeSender Out(Local, Pair.Fds[0]);
+        Out.Forward<TPingEvent>(KPingTag);
+        TSocketBridgeReceiver In(Local, Pair.Fds[0]);
+        In.Route<TPongEvent>(KPongTag);
+
+        std::vector<std::chrono::steady_clock::duration> Samples;
+        Samples.reserve(KRoundTrips);
+        for (int i = 0; i < KRoundTrips; ++i) {
+            const auto Sent = std::chrono::steady_clock::now();
+            Local.Dispatch(TPingEvent{static_cast<std::uint64_t>(i)});
+            Out.Flush();
+            while (In.Receive() == 0) {
+            }
+            Samples.push_back(std::chrono::steady_clock::now() - Sent);
+        }
+        Echo.join();
+
+        std::sort(Samples.begin(), Samples.end());
+        auto Micros = [](std::chrono::steady_clock::duration Value) {
+            return std::chrono::duration<double, std::micro>(Value).count();
+        };
+        std::chrono::steady_clock::duration Total{0};
+        for (const auto Sample : Samples) {
+            Total += Sample;
+        }
+        std::cout << "bridge round trip: " << KRoundTrips << " ping/pong, mean " << Micros(Total / KRoundTrips)
+                  << " us, p50 " << Micros(Samples[Samples.size() / 2]) << " us, p99 "
+                  << Micros(Samples[Samples.size() * 99 / 100]) << " us\n";
+    }
+
+} // namespace
+
+int main() {
+    BenchPerEventSend();
+    BenchBridge();
+    BenchRoundTrip();
+    return 0;
+}
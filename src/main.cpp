@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "event_system/EventSystem.hpp"
+#include "event_system/TickScheduler.hpp"
 
 using namespace NEventSystem;
 
@@ -134,6 +135,22 @@ void demoOneShotRace(TEventSystem& Sys) {
     }
 }
 
+void demoFixedTick(TEventSystem& Sys) {
+    std::cout << "\n--- Demo 6: Fixed-timestep ticks ---\n";
+
+    int Ticks = 0;
+    TEventSystem::TScopedConnection conn(
+        Sys,
+        Sys.Subscribe<TPhysicsTickEvent>(TEventSystem::Priority::Normal, [&](const auto&) {
+            ++Ticks;
+        }));
+
+    // Кадр в 50 мс при шаге 16 мс: три тика и остаток для интерполяции.
+    TFixedTickScheduler<TPhysicsTickEvent> Scheduler(Sys, std::chrono::milliseconds(16));
+    const auto Report = Scheduler.Advance(std::chrono::milliseconds(50));
+    std::cout << "Ticks: " << Ticks << ", alpha: " << Report.Alpha << "\n";
+}
+
 int main() {
     TEventSystem Sys;
 
@@ -142,6 +159,7 @@ int main() {
     demoOneShot(Sys);
     demoMultithreading(Sys);
     demoOneShotRace(Sys);
+    demoFixedTick(Sys);
     std::cout << "\nAll demos finished successfully!\n";
     return 0;
 }
\ No newline at end of file
@@ -2,8 +2,18 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
 #include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "event_system/EventSystem.hpp"
@@ -514,3 +524,900 @@ TEST(EventSystemAdvanced, ConcurrentSubscribeUnsubscribeAndDispatchDoesNotCrash)
 
     SUCCEED();
 }
+
+struct TInputEvent {
+    float Axis;
+    std::string Source;
+};
+
+TEST(EventSystemAdvanced, MutableStagesRunBeforeConstHandlersInPriorityOrder) {
+    TEventSystem Sys;
+    std::vector<std::string> Log;
+
+    Sys.Subscribe<TInputEvent>(TEventSystem::Priority::High, [&](const TInputEvent& e) {
+        Log.push_back("const:" + std::to_string(e.Axis));
+    });
+    // Мёртвая зона (Normal), затем нормализация (High).
+    Sys.SubscribeMutable<TInputEvent>(TEventSystem::Priority::Normal, [&](TInputEvent& e) {
+        Log.push_back("deadzone");
+        if (e.Axis < 0.5f) {
+            e.Axis = 0.0f;
+        }
+    });
+    Sys.SubscribeMutable<TInputEvent>(TEventSystem::Priority::High, [&](TInputEvent& e) {
+        Log.push_back("normalize");
+        e.Axis /= 100.0f;
+    });
+
+    Sys.Dispatch(TInputEvent{40.0f, "pad"});
+    Sys.Dispatch(TInputEvent{80.0f, "pad"});
+
+    ASSERT_EQ(Log.size(), 6u);
+    EXPECT_EQ(Log[0], "normalize");
+    EXPECT_EQ(Log[1], "deadzone");
+    EXPECT_EQ(Log[2], "const:" + std::to_string(0.0f));
+    EXPECT_EQ(Log[5], "const:" + std::to_string(0.8f));
+}
+
+TEST(EventSystemAdvanced, MutableStageDoesNotTouchConstDispatchedEvent) {
+    TEventSystem Sys;
+    float Seen = 0.0f;
+
+    auto StageId = Sys.SubscribeMutable<TInputEvent>(TEventSystem::Priority::Normal, [](TInputEvent& e) {
+        e.Axis = 1.0f;
+    });
+    Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, [&](const TInputEvent& e) {
+        Seen = e.Axis;
+    });
+    EXPECT_EQ(Sys.GetHandlerCount<TInputEvent>(), 2u);
+
+    const TInputEvent Original{5.0f, "kb"};
+    Sys.Dispatch(Original);
+    EXPECT_EQ(Seen, 1.0f);
+    EXPECT_EQ(Original.Axis, 5.0f);
+
+    Sys.Unsubscribe(StageId);
+    Sys.Dispatch(Original);
+    EXPECT_EQ(Seen, 5.0f);
+}
+
+namespace {
+
+    struct TPayloadEvent {
+        inline static int Copies = 0;
+
+        std::string Buffer;
+
+        explicit TPayloadEvent(std::string buffer)
+            : Buffer(std::move(buffer)) {
+        }
+
+        TPayloadEvent(const TPayloadEvent& other)
+            : Buffer(other.Buffer) {
+            ++Copies;
+        }
+
+        TPayloadEvent(TPayloadEvent&&) = default;
+    };
+
+} // namespace
+
+TEST(EventSystemAdvanced, SinkRunsLastAndTakesOwnershipOfRvalue) {
+    TEventSystem Sys;
+    std::vector<std::string> Log;
+    std::string Stored;
+
+    Sys.SubscribeSink<TPayloadEvent>([&](TPayloadEvent&& e) {
+        Log.push_back("sink");
+        Stored = std::move(e.Buffer);
+    });
+    Sys.Subscribe<TPayloadEvent>(TEventSystem::Priority::Low, [&](const TPayloadEvent& e) {
+        Log.push_back("low:" + e.Buffer);
+    });
+
+    TPayloadEvent::Copies = 0;
+    Sys.Dispatch(TPayloadEvent{std::string(64, 'x')});
+
+    EXPECT_EQ(TPayloadEvent::Copies, 0);
+    EXPECT_EQ(Stored, std::string(64, 'x'));
+    ASSERT_EQ(Log.size(), 2u);
+    EXPECT_EQ(Log[1], "sink");
+
+    // Константное событие сток получает копией, оригинал не трогается.
+    const TPayloadEvent Original{"keep"};
+    Sys.Dispatch(Original);
+    EXPECT_EQ(TPayloadEvent::Copies, 1);
+    EXPECT_EQ(Original.Buffer, "keep");
+    EXPECT_EQ(Stored, "keep");
+}
+
+TEST(EventSystemAdvanced, OnlyOneSinkPerEventType) {
+    TEventSystem Sys;
+
+    auto SinkId = Sys.SubscribeSink<TPayloadEvent>([](TPayloadEvent&&) {});
+    EXPECT_THROW(Sys.SubscribeSink<TPayloadEvent>([](TPayloadEvent&&) {}), std::logic_error);
+    EXPECT_EQ(Sys.GetHandlerCount<TPayloadEvent>(), 1u);
+
+    Sys.Unsubscribe(SinkId);
+    EXPECT_EQ(Sys.GetHandlerCount<TPayloadEvent>(), 0u);
+    EXPECT_NO_THROW(Sys.SubscribeSink<TPayloadEvent>([](TPayloadEvent&&) {}));
+}
+
+namespace {
+
+    struct TTickEvent {
+        float Dt;
+    };
+
+    struct TWideEvent {
+        double Values[4];
+    };
+
+    static_assert(std::is_same_v<NInternal::TEventArg<TTickEvent>, TTickEvent>);
+    static_assert(std::is_same_v<NInternal::TEventArg<TWideEvent>, const TWideEvent&>);
+    static_assert(std::is_same_v<NInternal::TEventArg<TPayloadEvent>, const TPayloadEvent&>);
+
+} // namespace
+
+TEST(EventSystemAdvanced, SmallEventsReachConstRefHandlersByValue) {
+    TEventSystem Sys;
+    float Sum = 0.0f;
+    std::vector<int> Captured{1, 2, 3};
+
+    Sys.Subscribe<TTickEvent>(TEventSystem::Priority::High, [&](const TTickEvent& e) {
+        Sum += e.Dt;
+    });
+    Sys.Subscribe<TTickEvent>(TEventSystem::Priority::Normal, [&Sum](const auto& e) {
+        Sum += e.Dt * 10.0f;
+    });
+    // Захват не помещается во встроенный буфер — обработчик уходит в кучу.
+    Sys.Subscribe<TTickEvent>(TEventSystem::Priority::Low, [&Sum, Captured](const TTickEvent& e) {
+        Sum += e.Dt * static_cast<float>(Captured.size());
+    });
+
+    Sys.Dispatch(TTickEvent{0.5f});
+    EXPECT_FLOAT_EQ(Sum, 0.5f + 5.0f + 1.5f);
+
+    double Total = 0.0;
+    std::function<void(const TWideEvent&)> Handler = [&](const TWideEvent& e) {
+        Total += e.Values[3];
+    };
+    Sys.Subscribe<TWideEvent>(TEventSystem::Priority::Normal, Handler);
+    Sys.Dispatch(TWideEvent{{1.0, 2.0, 3.0, 4.0}});
+    EXPECT_DOUBLE_EQ(Total, 4.0);
+}
+
+namespace {
+
+    float FreeTickSum = 0.0f;
+    double FreeWideSum = 0.0;
+
+    void OnFreeTick(const TTickEvent& e) {
+        FreeTickSum += e.Dt;
+    }
+
+    void OnFreeWide(const TWideEvent& e) {
+        FreeWideSum += e.Values[0];
+    }
+
+} // namespace
+
+TEST(EventSystemAdvanced, FreeFunctionsSubscribeDirectly) {
+    TEventSystem Sys;
+    FreeTickSum = 0.0f;
+    FreeWideSum = 0.0;
+
+    Sys.Subscribe<TTickEvent>(TEventSystem::Priority::Normal, OnFreeTick);
+    Sys.Subscribe<TTickEvent>(TEventSystem::Priority::Low, &OnFreeTick);
+    Sys.Subscribe<TWideEvent>(TEventSystem::Priority::Normal, OnFreeWide);
+
+    Sys.Dispatch(TTickEvent{0.25f});
+    Sys.Dispatch(TWideEvent{{2.0, 0.0, 0.0, 0.0}});
+    EXPECT_FLOAT_EQ(FreeTickSum, 0.5f);
+    EXPECT_DOUBLE_EQ(FreeWideSum, 2.0);
+}
+
+TEST(EventSystemAdvanced, StringTopicsDispatchOpaquePayloads) {
+    // Id топика получается только из Intern: ни id типа, ни число не подходят.
+    static_assert(!std::is_constructible_v<TTopicId, std::uint32_t>);
+    static_assert(!std::is_default_constructible_v<TTopicId>);
+
+    TEventSystem Sys;
+
+    const TTopicId Damage = TEventSystem::Intern("combat.damage");
+    const TTopicId Heal = TEventSystem::Intern("combat.heal");
+    EXPECT_EQ(TEventSystem::Intern(std::string("combat.damage")), Damage);
+    EXPECT_NE(Damage, Heal);
+
+    std::vector<std::string> Log;
+    Sys.Subscribe(Damage, TEventSystem::Priority::Low, [&](const TTopicEvent& e) {
+        Log.push_back("low:" + std::string(reinterpret_cast<const char*>(e.Payload.data()), e.Payload.size()));
+    });
+    auto Id = Sys.Subscribe(Damage, TEventSystem::Priority::High, [&](const TTopicEvent& e) {
+        EXPECT_EQ(e.Topic, Damage);
+        Log.push_back("high");
+    });
+    Sys.Subscribe(Heal, TEventSystem::Priority::Normal, [&](const TTopicEvent&) {
+        Log.push_back("heal");
+    });
+    EXPECT_EQ(Sys.GetHandlerCount(Damage), 2u);
+
+    const std::string Payload = "42";
+    Sys.Dispatch(Damage, std::as_bytes(std::span(Payload)));
+    EXPECT_EQ(Log, (std::vector<std::string>{"high", "low:42"}));
+
+    Sys.Unsubscribe(Id);
+    Log.clear();
+    Sys.Dispatch(Damage, std::as_bytes(std::span(Payload)));
+    Sys.Dispatch(TEventSystem::Intern("combat.unknown"), {});
+    EXPECT_EQ(Log, (std::vector<std::string>{"low:42"}));
+}
+
+TEST(EventSystemAdvanced, OrderingConstraintsOverridePriorities) {
+    TEventSystem Sys;
+    std::vector<std::string> Log;
+
+    Sys.Subscribe<TInputEvent>(TEventSystem::Priority::High, TOrdering{"render", {}, {}}, [&](const TInputEvent&) {
+        Log.push_back("render");
+    });
+    Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, [&](const TInputEvent&) {
+        Log.push_back("plain");
+    });
+    Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Low, TOrdering{"integrate", {"render"}, {"collision"}},
+                               [&](const TInputEvent&) {
+                                   Log.push_back("integrate");
+                               });
+    Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Low, TOrdering{"collision", {}, {}}, [&](const TInputEvent&) {
+        Log.push_back("collision");
+    });
+
+    Sys.Dispatch(TInputEvent{});
+    EXPECT_EQ(Log, (std::vector<std::string>{"plain", "collision", "integrate", "render"}));
+}
+
+TEST(EventSystemAdvanced, OrderingCycleIsReportedAndRejected) {
+    TEventSystem Sys;
+    Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, TOrdering{"a", {"b"}, {}}, [](const TInputEvent&) {});
+    Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, TOrdering{"b", {"c"}, {}}, [](const TInputEvent&) {});
+    // Только после цикла, но в него не входит.
+    Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, TOrdering{"downstream", {}, {"c"}},
+                               [](const TInputEvent&) {});
+
+    try {
+        Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, TOrdering{"c", {"a"}, {}}, [](const TInputEvent&) {});
+        FAIL() << "cycle was not reported";
+    } catch (const std::logic_error& e) {
+        const std::string Message = e.what();
+        EXPECT_NE(Message.find(" a"), std::string::npos);
+        EXPECT_NE(Message.find(" b"), std::string::npos);
+        EXPECT_NE(Message.find(" c"), std::string::npos);
+        EXPECT_EQ(Message.find("downstream"), std::string::npos);
+    }
+    EXPECT_EQ(Sys.GetHandlerCount<TInputEvent>(), 3u);
+}
+
+TEST(EventSystemAdvanced, UnsubscribedLabelAddsNoOrderingEdges) {
+    TEventSystem Sys;
+    std::vector<std::string> Log;
+
+    // Обычные обработчики держат надгробие A в таблице до уплотнения.
+    for (int i = 0; i < 3; ++i) {
+        Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Low, [&](const TInputEvent&) { Log.push_back("plain"); });
+    }
+    const auto A = Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, TOrdering{"a", {"b"}, {}},
+                                              [&](const TInputEvent&) { Log.push_back("a"); });
+    Sys.Unsubscribe(A);
+
+    EXPECT_NO_THROW(Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Low, TOrdering{"b", {"a"}, {}},
+                                               [&](const TInputEvent&) { Log.push_back("b"); }));
+    Sys.Subscribe<TInputEvent>(TEventSystem::Priority::High, TOrdering{"a", {}, {}},
+                               [&](const TInputEvent&) { Log.push_back("a2"); });
+    EXPECT_EQ(Sys.GetHandlerCount<TInputEvent>(), 5u);
+
+    Sys.Dispatch(TInputEvent{});
+    EXPECT_EQ(Log, (std::vector<std::string>{"plain", "plain", "plain", "b", "a2"}));
+}
+
+TEST(EventSystemAdvanced, PauseResumeAndSetPriorityKeepSubscription) {
+    TEventSystem Sys;
+    std::vector<std::string> Log;
+
+    auto Overlay = Sys.Subscribe<TInputEvent>(TEventSystem::Priority::High, [&](const TInputEvent&) {
+        Log.push_back("overlay");
+    });
+    auto Game = Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, [&](const TInputEvent&) {
+        Log.push_back("game");
+    });
+
+    EXPECT_TRUE(Sys.Pause(Overlay));
+    Sys.Dispatch(TInputEvent{});
+    EXPECT_EQ(Log, (std::vector<std::string>{"game"}));
+    EXPECT_EQ(Sys.GetHandlerCount<TInputEvent>(), 2u);
+
+    EXPECT_TRUE(Sys.Resume(Overlay));
+    EXPECT_TRUE(Sys.SetPriority(Game, std::int16_t{2000}));
+    Log.clear();
+    Sys.Dispatch(TInputEvent{});
+    EXPECT_EQ(Log, (std::vector<std::string>{"game", "overlay"}));
+
+    Sys.Unsubscribe(Game);
+    EXPECT_FALSE(Sys.Pause(Game));
+    EXPECT_FALSE(Sys.SetPriority(Game, TEventSystem::Priority::Low));
+}
+
+TEST(EventSystemAdvanced, ConcurrentPauseResumeKeepsLiveMaskConsistent) {
+    TEventSystem Sys;
+    int Calls = 0;
+    auto Id = Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, [&](const TInputEvent&) {
+        ++Calls;
+    });
+
+    // Pause и Resume стартуют одновременно; победить может любой, но если
+    // обработчик не на паузе (DispatchLazy видит слушателя), Dispatch
+    // обязан его вызвать, а не пропустить из-за бита, погашенного Pause.
+    constexpr int KRounds = 2000;
+    std::atomic<int> Started{0};
+    std::atomic<int> Finished{0};
+    auto Worker = [&](bool PausedV) {
+        for (int Round = 1; Round <= KRounds; ++Round) {
+            while (Started.load(std::memory_order_acquire) < Round) {
+                std::this_thread::yield();
+            }
+            PausedV ? Sys.Pause(Id) : Sys.Resume(Id);
+            Finished.fetch_add(1, std::memory_order_acq_rel);
+        }
+    };
+    std::thread Pauser(Worker, true);
+    std::thread Resumer(Worker, false);
+
+    for (int Round = 1; Round <= KRounds; ++Round) {
+        Sys.Pause(Id);
+        Started.store(Round, std::memory_order_release);
+        while (Finished.load(std::memory_order_acquire) != 2 * Round) {
+            std::this_thread::yield();
+        }
+
+        const int Before = Calls;
+        const bool Listening = Sys.DispatchLazy<TInputEvent>([] { return TInputEvent{}; });
+        if (Listening && Calls == Before) {
+            ADD_FAILURE() << "resumed handler skipped in round " << Round;
+            Started.store(KRounds, std::memory_order_release);
+            break;
+        }
+    }
+
+    Pauser.join();
+    Resumer.join();
+}
+
+TEST(EventSystemAdvanced, ReplaceSwapsCallableAndKeepsPosition) {
+    TEventSystem Sys;
+    std::vector<std::string> Log;
+    auto Token = std::make_shared<int>(0);
+
+    TEventSystem::HandlerId Tuned = 0;
+    Sys.Subscribe<TInputEvent>(TEventSystem::Priority::High, [&](const TInputEvent& e) {
+        Log.push_back("first");
+        if (e.Source == "reload") {
+            EXPECT_TRUE(Sys.Replace<TInputEvent>(Tuned, [&, Token](const TInputEvent&) { Log.push_back("mid"); }));
+        }
+    });
+    Tuned = Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, [&](const TInputEvent&) {
+        Log.push_back("old");
+    });
+    Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Low, [&](const TInputEvent&) { Log.push_back("last"); });
+
+    // Идущий Dispatch вызывает старый или новый обработчик, но не пропускает его.
+    Sys.Dispatch(TInputEvent{0.0f, "reload"});
+    ASSERT_EQ(Log.size(), 3u);
+    EXPECT_EQ(Log[0], "first");
+    EXPECT_TRUE(Log[1] == "old" || Log[1] == "mid") << Log[1];
+    EXPECT_EQ(Log[2], "last");
+
+    Log.clear();
+    Sys.Dispatch(TInputEvent{});
+    EXPECT_EQ(Log, (std::vector<std::string>{"first", "mid", "last"}));
+
+    // Прошлая замена освобождается, как только её никто не вызывает.
+    EXPECT_EQ(Token.use_count(), 2);
+    EXPECT_TRUE(Sys.Replace<TInputEvent>(Tuned, [&](const TInputEvent&) { Log.push_back("new"); }));
+    EXPECT_EQ(Token.use_count(), 1);
+
+    // Пауза и приоритет относятся к тому же слоту.
+    EXPECT_TRUE(Sys.Pause(Tuned));
+    Log.clear();
+    Sys.Dispatch(TInputEvent{});
+    EXPECT_EQ(Log, (std::vector<std::string>{"first", "last"}));
+    EXPECT_TRUE(Sys.Resume(Tuned));
+    EXPECT_TRUE(Sys.SetPriority(Tuned, TEventSystem::Priority::High));
+    Log.clear();
+    Sys.Dispatch(TInputEvent{});
+    EXPECT_EQ(Log, (std::vector<std::string>{"first", "new", "last"}));
+
+    EXPECT_FALSE(Sys.Replace<TPayloadEvent>(Tuned, [](const TPayloadEvent&) {}));
+    Sys.Unsubscribe(Tuned);
+    EXPECT_FALSE(Sys.Replace<TInputEvent>(Tuned, [](const TInputEvent&) {}));
+}
+
+TEST(EventSystemAdvanced, ConcurrentReplaceNeverDropsDispatch) {
+    TEventSystem Sys;
+    std::atomic<int> Calls{0};
+    auto Id = Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, [&](const TInputEvent&) {
+        Calls.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    std::atomic<bool> Stop{false};
+    std::thread Swapper([&] {
+        for (int i = 0; !Stop.load(std::memory_order_relaxed) && i < 20000; ++i) {
+            Sys.Replace<TInputEvent>(Id, [&](const TInputEvent&) {
+                Calls.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+    });
+
+    constexpr int KDispatches = 20000;
+    for (int i = 0; i < KDispatches; ++i) {
+        Sys.Dispatch(TInputEvent{});
+    }
+    Stop.store(true, std::memory_order_relaxed);
+    Swapper.join();
+
+    EXPECT_EQ(Calls.load(), KDispatches);
+}
+
+TEST(EventSystemAdvanced, ReplacedSlotStaysQuietAfterUnsubscribe) {
+    TEventSystem Sys;
+    std::vector<std::string> Log;
+
+    TEventSystem::HandlerId Tuned = 0;
+    Sys.Subscribe<TInputEvent>(TEventSystem::Priority::High, [&](const TInputEvent&) {
+        Sys.Replace<TInputEvent>(Tuned, [&](const TInputEvent&) { Log.push_back("new"); });
+        Sys.Unsubscribe(Tuned);
+    });
+    Tuned = Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, [&](const TInputEvent&) {
+        Log.push_back("old");
+    });
+
+    Sys.Dispatch(TInputEvent{});
+    Sys.Dispatch(TInputEvent{});
+    EXPECT_TRUE(Log.empty());
+}
+
+TEST(EventSystemAdvanced, SparseLiveHandlersAcrossManyWords) {
+    TEventSystem Sys;
+    constexpr int KHandlers = 1000;
+
+    std::vector<int> Calls(KHandlers, 0);
+    std::vector<TEventSystem::HandlerId> Ids;
+    for (int i = 0; i < KHandlers; ++i) {
+        Ids.push_back(Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, [&Calls, i](const TInputEvent&) {
+            ++Calls[i];
+        }));
+    }
+
+    // Оставляем каждый десятый обработчик, ещё часть из них ставим на паузу.
+    for (int i = 0; i < KHandlers; ++i) {
+        if (i % 10 != 0) {
+            Sys.Unsubscribe(Ids[i]);
+        } else if (i % 20 == 0) {
+            Sys.Pause(Ids[i]);
+        }
+    }
+    EXPECT_EQ(Sys.GetHandlerCount<TInputEvent>(), 100u);
+
+    Sys.Dispatch(TInputEvent{});
+    for (int i = 0; i < KHandlers; ++i) {
+        EXPECT_EQ(Calls[i], i % 20 == 10 ? 1 : 0) << i;
+    }
+
+    Sys.Resume(Ids[980]);
+    Sys.Dispatch(TInputEvent{});
+    EXPECT_EQ(Calls[980], 1);
+    EXPECT_EQ(Calls[990], 2);
+}
+
+TEST(EventSystemAdvanced, DispatchLazyBuildsEventOnlyForListeners) {
+    TEventSystem Sys;
+    int Built = 0;
+    std::vector<std::string> Received;
+    auto Factory = [&] {
+        ++Built;
+        return TInputEvent{1.0f, "expensive"};
+    };
+
+    EXPECT_FALSE(Sys.DispatchLazy<TInputEvent>(Factory));
+
+    auto Id = Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, [&](const TInputEvent& e) {
+        Received.push_back(e.Source);
+    });
+    EXPECT_TRUE(Sys.DispatchLazy<TInputEvent>(Factory));
+    EXPECT_EQ(Built, 1);
+    EXPECT_EQ(Received, (std::vector<std::string>{"expensive"}));
+
+    Sys.Pause(Id);
+    EXPECT_FALSE(Sys.DispatchLazy<TInputEvent>(Factory));
+    Sys.Resume(Id);
+    EXPECT_TRUE(Sys.DispatchLazy<TInputEvent>(Factory));
+
+    Sys.Unsubscribe(Id);
+    EXPECT_FALSE(Sys.DispatchLazy<TInputEvent>(Factory));
+    EXPECT_EQ(Built, 2);
+
+    // Одноразовый обработчик перестаёт слушать после срабатывания.
+    Sys.SubscribeOnce<TInputEvent>(TEventSystem::Priority::Normal, [](const TInputEvent&) {});
+    EXPECT_TRUE(Sys.DispatchLazy<TInputEvent>(Factory));
+    EXPECT_FALSE(Sys.DispatchLazy<TInputEvent>(Factory));
+    EXPECT_EQ(Built, 3);
+}
+
+TEST(EventSystemAdvanced, RegisterAndReserveBeforeStartup) {
+    TEventSystem Sys;
+    Sys.Reserve(16, 1024);
+    Sys.Register<TInputEvent>(512);
+    Sys.Register<TPayloadEvent>(8);
+
+    EXPECT_EQ(Sys.GetHandlerCount<TInputEvent>(), 0u);
+    EXPECT_FALSE(Sys.DispatchLazy<TInputEvent>([] { return TInputEvent{}; }));
+    const auto Capacity = Sys.GetHandlerCapacity<TInputEvent>();
+    EXPECT_GE(Capacity, 512u);
+    EXPECT_GE(Sys.GetHandlerCapacity<TPayloadEvent>(), 8u);
+
+    int Calls = 0;
+    for (int i = 0; i < 512; ++i) {
+        Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, [&Calls](const TInputEvent&) { ++Calls; });
+    }
+    // Все подписки легли в заранее выделенный список.
+    EXPECT_EQ(Sys.GetHandlerCapacity<TInputEvent>(), Capacity);
+    Sys.Dispatch(TInputEvent{});
+    EXPECT_EQ(Calls, 512);
+}
+
+namespace {
+
+    struct TDepthEvent {
+        int Value;
+    };
+
+} // namespace
+
+TEST(EventSystemAdvanced, DeepRecursiveDispatchSpillsFrameStack) {
+    TEventSystem Sys;
+    std::vector<int> Depths;
+
+    // Глубже встроенного стека кадров: подписка на самом дне всё равно
+    // видит текущее событие, а кадры снимаются в обратном порядке.
+    Sys.Subscribe<TDepthEvent>(TEventSystem::Priority::Normal, [&](const TDepthEvent& e) {
+        if (e.Value < 40) {
+            Sys.Dispatch(TDepthEvent{e.Value + 1});
+        } else {
+            Sys.Subscribe<TDepthEvent>(TEventSystem::Priority::Low, [&](const TDepthEvent& Inner) {
+                Depths.push_back(Inner.Value);
+            });
+        }
+    });
+
+    Sys.Dispatch(TDepthEvent{0});
+    EXPECT_EQ(Depths, (std::vector<int>{40}));
+}
+
+TEST(EventSystemAdvanced, CapacityProfileRoundTrip) {
+    const auto Path = std::filesystem::temp_directory_path() / "event_system_capacity_profile.txt";
+    std::filesystem::remove(Path);
+
+    {
+        TEventSystem Sys;
+        EXPECT_FALSE(Sys.LoadCapacityProfile(Path));
+
+        for (int i = 0; i < 3; ++i) {
+            Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, [](const TInputEvent&) {});
+        }
+        const auto Topic = TEventSystem::Intern("capacity.profile.topic");
+        Sys.Subscribe(Topic, TEventSystem::Priority::Normal, [](const TTopicEvent&) {});
+
+        for (int i = 0; i < 5; ++i) {
+            Sys.Enqueue(TInputEvent{});
+        }
+        Sys.Enqueue(TEventSystem::Priority::High, TInputEvent{});
+        Sys.DrainReady(100);
+        Sys.Enqueue(TInputEvent{});
+        Sys.DrainReady(100);
+
+        Sys.ExportCapacityProfile(Path);
+    }
+
+    std::ifstream In(Path);
+    const std::string Text((std::istreambuf_iterator<char>(In)), std::istreambuf_iterator<char>());
+    EXPECT_NE(Text.find("3 6 type:"), std::string::npos);
+    EXPECT_NE(Text.find("1 0 topic:capacity.profile.topic"), std::string::npos);
+    EXPECT_NE(Text.find("0 1 queue:high"), std::string::npos);
+    EXPECT_NE(Text.find("0 5 queue:normal"), std::string::npos);
+    EXPECT_NE(Text.find("0 0 queue:low"), std::string::npos);
+
+    TEventSystem Restarted;
+    EXPECT_TRUE(Restarted.LoadCapacityProfile(Path));
+    const auto Capacity = Restarted.GetQueueCapacity();
+    EXPECT_GE(Capacity.High, 1u);
+    EXPECT_GE(Capacity.Normal, 5u);
+    // По пикам полос, а не по сумме пиков типов.
+    EXPECT_LT(Capacity.Normal, 6u);
+
+    int Calls = 0;
+    Restarted.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, [&Calls](const TInputEvent&) { ++Calls; });
+    Restarted.Dispatch(TInputEvent{});
+    EXPECT_EQ(Calls, 1);
+
+    std::filesystem::remove(Path);
+}
+
+namespace {
+
+    struct TChurnEvent {
+        int Value = 0;
+    };
+
+} // namespace
+
+TEST(EventSystemAdvanced, CapacityProfileCountsLiveHandlersOnly) {
+    const auto Path = std::filesystem::temp_directory_path() / "event_system_capacity_churn.txt";
+    std::filesystem::remove(Path);
+
+    TEventSystem Sys;
+    std::vector<TEventSystem::HandlerId> Ids;
+    for (int i = 0; i < 3; ++i) {
+        Ids.push_back(Sys.Subscribe<TChurnEvent>(TEventSystem::Priority::Normal, [](const TChurnEvent&) {}));
+    }
+    // Отток: надгробия остаются в списке до уплотнения, но в пик не идут.
+    for (int Round = 0; Round < 4; ++Round) {
+        Sys.Unsubscribe(Ids.back());
+        Ids.back() = Sys.Subscribe<TChurnEvent>(TEventSystem::Priority::Normal, [](const TChurnEvent&) {});
+    }
+    Sys.ExportCapacityProfile(Path);
+
+    std::ifstream In(Path);
+    std::string Line;
+    std::string Churn;
+    while (std::getline(In, Line)) {
+        if (Line.find("TChurnEvent") != std::string::npos) {
+            Churn = Line;
+        }
+    }
+    EXPECT_EQ(Churn.rfind("3 0 type:", 0), 0u) << Churn;
+
+    std::filesystem::remove(Path);
+}
+
+TEST(EventSystemAdvanced, InternRejectsLineBreaks) {
+    EXPECT_THROW(TEventSystem::Intern("bad\ntopic"), std::invalid_argument);
+    EXPECT_NO_THROW(TEventSystem::Intern("good topic"));
+}
+
+TEST(EventSystemAdvanced, ClearDropsAllSubscriptionsAtOnce) {
+    TEventSystem Sys;
+    auto Tracker = std::make_shared<int>(0);
+
+    for (int i = 0; i < 1000; ++i) {
+        Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, [Tracker](const TInputEvent&) { ++*Tracker; });
+    }
+    Sys.SubscribeMutable<TPayloadEvent>(TEventSystem::Priority::Normal, [Tracker](TPayloadEvent&) { ++*Tracker; });
+    const auto Id = Sys.Subscribe<TPayloadEvent>(TEventSystem::Priority::Normal, [Tracker](const TPayloadEvent&) {});
+    EXPECT_EQ(Tracker.use_count(), 1003);
+
+    Sys.Clear();
+
+    EXPECT_EQ(Tracker.use_count(), 1);
+    EXPECT_EQ(Sys.GetHandlerCount<TInputEvent>(), 0u);
+    EXPECT_EQ(Sys.GetHandlerCount<TPayloadEvent>(), 0u);
+    EXPECT_FALSE(Sys.Pause(Id));
+    Sys.Unsubscribe(Id);
+
+    Sys.Dispatch(TInputEvent{});
+    EXPECT_EQ(*Tracker, 0);
+
+    int Calls = 0;
+    Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal, [&Calls](const TInputEvent&) { ++Calls; });
+    Sys.Dispatch(TInputEvent{});
+    EXPECT_EQ(Calls, 1);
+}
+
+TEST(EventSystemAdvanced, ClearConcurrentWithSubscribeKeepsIdsConsistent) {
+    TEventSystem Sys;
+    std::vector<TEventSystem::HandlerId> Ids;
+    std::atomic<bool> Done{false};
+    std::atomic<int> Calls{0};
+
+    std::thread Subscriber([&] {
+        for (int i = 0; i < 2000; ++i) {
+            Ids.push_back(Sys.Subscribe<TInputEvent>(TEventSystem::Priority::Normal,
+                                                     [&Calls](const TInputEvent&) { ++Calls; }));
+        }
+        Done = true;
+    });
+    while (!Done) {
+        Sys.Clear();
+    }
+    Subscriber.join();
+
+    // Каждый выданный id либо снят целиком, либо жив целиком.
+    std::size_t Live = 0;
+    for (const auto Id : Ids) {
+        if (Sys.Pause(Id)) {
+            ++Live;
+            EXPECT_TRUE(Sys.Resume(Id));
+        }
+    }
+    EXPECT_EQ(Sys.GetHandlerCount<TInputEvent>(), Live);
+    Sys.Dispatch(TInputEvent{});
+    EXPECT_EQ(Calls, static_cast<int>(Live));
+}
+
+namespace {
+
+    struct TShotEvent {
+        float X;
+        float Y;
+    };
+
+} // namespace
+
+template <>
+struct NEventSystem::TPositionOf<TShotEvent> {
+    static constexpr float CellSize = 10.0f;
+
+    static TPoint Get(const TShotEvent& e) {
+        return {e.X, e.Y};
+    }
+};
+
+TEST(EventSystemAdvanced, RegionSubscribersGetOnlyNearbyEvents) {
+    TEventSystem Sys;
+    std::vector<std::string> Log;
+
+    Sys.Subscribe<TShotEvent>(TEventSystem::Priority::Normal, [&](const TShotEvent&) { Log.push_back("all"); });
+    const auto Alice = Sys.SubscribeInRegion<TShotEvent>({0, 0, 20, 20}, TEventSystem::Priority::Normal,
+                                                         [&](const TShotEvent&) { Log.push_back("alice"); });
+    const auto Bob = Sys.SubscribeInRegion<TShotEvent>({100, 100, 110, 110}, TEventSystem::Priority::Normal,
+                                                       [&](const TShotEvent&) { Log.push_back("bob"); });
+    // Область шире лимита ячеек проверяется на каждом событии.
+    Sys.SubscribeInRegion<TShotEvent>({-1e6f, -1e6f, 1e6f, 1e6f}, TEventSystem::Priority::High,
+                                      [&](const TShotEvent&) { Log.push_back("world"); });
+    EXPECT_EQ(Sys.GetHandlerCount<TShotEvent>(), 4u);
+
+    // Подписчики по области идут в общем порядке приоритетов.
+    Sys.Dispatch(TShotEvent{5, 5});
+    EXPECT_EQ(Log, (std::vector<std::string>{"world", "all", "alice"}));
+
+    Log.clear();
+    EXPECT_TRUE(Sys.MoveRegion<TShotEvent>(Alice, {100, 100, 105, 105}));
+    Sys.Dispatch(TShotEvent{5, 5});
+    Sys.Dispatch(TShotEvent{102, 102});
+    Sys.Dispatch(TShotEvent{108, 108});
+    EXPECT_EQ(Log, (std::vector<std::string>{"world", "all", "world", "all", "bob", "alice", "world", "all", "bob"}));
+
+    Log.clear();
+    EXPECT_TRUE(Sys.Pause(Bob));
+    Sys.Unsubscribe(Alice);
+    Sys.Dispatch(TShotEvent{102, 102});
+    EXPECT_EQ(Log, (std::vector<std::string>{"world", "all"}));
+    EXPECT_EQ(Sys.GetHandlerCount<TShotEvent>(), 3u);
+    EXPECT_FALSE(Sys.MoveRegion<TShotEvent>(Alice, {0, 0, 1, 1}));
+}
+
+TEST(EventSystemAdvanced, RegionCellAndWideSubscribersMergeByPriority) {
+    TEventSystem Sys;
+    std::vector<std::string> Log;
+    auto Add = [&](const TRegion& Region, std::int16_t Priority, std::string Name) {
+        Sys.SubscribeInRegion<TShotEvent>(Region, TEventSystem::PriorityValue(Priority),
+                                          [&Log, Name](const TShotEvent&) { Log.push_back(Name); });
+    };
+    const TRegion Near{0, 0, 10, 10};
+    const TRegion World{-1e6f, -1e6f, 1e6f, 1e6f};
+
+    Add(Near, -1024, "cell-low");
+    Add(World, 600, "wide-600");
+    Add(Near, 0, "cell-0");
+    Add({5000, 5000, 1e6f, 1e6f}, 2000, "wide-far");
+    Add(World, 0, "wide-0");
+    Add(Near, 1024, "cell-high");
+    Add(World, -2000, "wide-lowest");
+
+    // При равном приоритете подписка ячейки идёт раньше широкой.
+    Sys.Dispatch(TShotEvent{5, 5});
+    EXPECT_EQ(Log, (std::vector<std::string>{"cell-high", "wide-600", "cell-0", "wide-0", "cell-low", "wide-lowest"}));
+}
+
+TEST(EventSystemAdvanced, RegionRejectsNonFiniteCoordinates) {
+    TEventSystem Sys;
+    std::vector<std::string> Log;
+    const float NaN = std::numeric_limits<float>::quiet_NaN();
+    const float Inf = std::numeric_limits<float>::infinity();
+
+    // Отказ первой же подписки не оставляет сетку наполовину созданной.
+    EXPECT_THROW(Sys.SubscribeInRegion<TShotEvent>({NaN, 0, 10, 10}, TEventSystem::Priority::Normal,
+                                                   [&](const TShotEvent&) { Log.push_back("nan"); }),
+                 std::invalid_argument);
+    const auto Near = Sys.SubscribeInRegion<TShotEvent>({0, 0, 10, 10}, TEventSystem::Priority::Normal,
+                                                        [&](const TShotEvent&) { Log.push_back("near"); });
+    EXPECT_THROW(Sys.SubscribeInRegion<TShotEvent>({-Inf, -Inf, Inf, Inf}, TEventSystem::Priority::Normal,
+                                                   [&](const TShotEvent&) { Log.push_back("inf"); }),
+                 std::invalid_argument);
+    EXPECT_THROW(Sys.MoveRegion<TShotEvent>(Near, {0, 0, Inf, 10}), std::invalid_argument);
+    EXPECT_EQ(Sys.GetHandlerCount<TShotEvent>(), 1u);
+
+    Sys.Dispatch(TShotEvent{NaN, 5});
+    Sys.Dispatch(TShotEvent{5, Inf});
+    Sys.Dispatch(TShotEvent{5, 5});
+    EXPECT_EQ(Log, (std::vector<std::string>{"near"}));
+}
+
+TEST(EventSystemAdvanced, ReplaceCoversRegionSubscribersOnly) {
+    TEventSystem Sys;
+    std::vector<std::string> Log;
+
+    const auto Near = Sys.SubscribeInRegion<TShotEvent>({0, 0, 10, 10}, TEventSystem::Priority::Normal,
+                                                        [&](const TShotEvent&) { Log.push_back("old"); });
+    const auto Stage = Sys.SubscribeMutable<TShotEvent>(TEventSystem::Priority::Normal, [&](TShotEvent&) {
+        Log.push_back("stage");
+    });
+    const auto Sink = Sys.SubscribeSink<TShotEvent>([&](TShotEvent&&) { Log.push_back("sink"); });
+
+    EXPECT_TRUE(Sys.Replace<TShotEvent>(Near, [&](const TShotEvent&) { Log.push_back("new"); }));
+    // У стадии и стока другая сигнатура: заменить их нельзя.
+    EXPECT_FALSE(Sys.Replace<TShotEvent>(Stage, [&](const TShotEvent&) { Log.push_back("bad"); }));
+    EXPECT_FALSE(Sys.Replace<TShotEvent>(Sink, [&](const TShotEvent&) { Log.push_back("bad"); }));
+
+    Sys.Dispatch(TShotEvent{5, 5});
+    EXPECT_EQ(Log, (std::vector<std::string>{"stage", "new", "sink"}));
+
+    Sys.Unsubscribe(Near);
+    EXPECT_FALSE(Sys.Replace<TShotEvent>(Near, [&](const TShotEvent&) { Log.push_back("bad"); }));
+}
+
+TEST(EventSystemAdvanced, SetPriorityDuringRegionDispatchKeepsTargets) {
+    TEventSystem Sys;
+    std::atomic<int> Plain{0};
+    std::atomic<int> Near{0};
+
+    const auto Mover = Sys.Subscribe<TShotEvent>(TEventSystem::Priority::Normal,
+                                                 [&](const TShotEvent&) { Plain.fetch_add(1, std::memory_order_relaxed); });
+    Sys.SubscribeInRegion<TShotEvent>({0, 0, 10, 10}, TEventSystem::Priority::Normal,
+                                      [&](const TShotEvent&) { Near.fetch_add(1, std::memory_order_relaxed); });
+
+    // Смена приоритета публикует новую таблицу и не трогает ту,
+    // по которой идёт Dispatch.
+    std::atomic<bool> Stop{false};
+    std::thread Writer([&] {
+        for (int i = 0; !Stop.load(std::memory_order_relaxed); ++i) {
+            Sys.SetPriority(Mover, i % 2 == 0 ? TEventSystem::Priority::High : TEventSystem::Priority::Low);
+        }
+    });
+
+    constexpr int KDispatches = 2000;
+    for (int i = 0; i < KDispatches; ++i) {
+        Sys.Dispatch(TShotEvent{5, 5});
+    }
+    Stop.store(true, std::memory_order_relaxed);
+    Writer.join();
+
+    EXPECT_EQ(Plain.load(), KDispatches);
+    EXPECT_EQ(Near.load(), KDispatches);
+}
+
+TEST(EventSystemAdvanced, NestedRegionDispatchKeepsOuterTargets) {
+    TEventSystem Sys;
+    std::vector<std::string> Log;
+    bool Nested = false;
+
+    Sys.SubscribeInRegion<TShotEvent>({0, 0, 10, 10}, TEventSystem::Priority::High, [&](const TShotEvent& e) {
+        Log.push_back("a");
+        if (!std::exchange(Nested, true)) {
+            Sys.Dispatch(e);
+        }
+    });
+    Sys.SubscribeInRegion<TShotEvent>({0, 0, 10, 10}, TEventSystem::Priority::Normal,
+                                      [&](const TShotEvent&) { Log.push_back("b"); });
+    Sys.SubscribeInRegion<TShotEvent>({-1e6f, -1e6f, 1e6f, 1e6f}, TEventSystem::Priority::Low,
+                                      [&](const TShotEvent&) { Log.push_back("w"); });
+
+    Sys.Dispatch(TShotEvent{5, 5});
+    EXPECT_EQ(Log, (std::vector<std::string>{"a", "a", "b", "w", "b", "w"}));
+}
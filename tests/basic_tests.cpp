@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include "event_system/EventSystem.hpp"
@@ -86,6 +87,23 @@ TEST(EventSystemBasic, PriorityOrder) {
     EXPECT_EQ(Log[2], "Low");
 }
 
+TEST(EventSystemBasic, NumericPriorityOrder) {
+    TEventSystem Sys;
+    std::vector<int> Order;
+
+    // Числовые приоритеты располагаются вокруг опорных значений EPriority.
+    Sys.Subscribe<TIntEvent>(TEventSystem::Priority::High, [&](const TIntEvent&) { Order.push_back(1); });
+    Sys.Subscribe<TIntEvent>(std::int16_t{TPriority::HighValue - 1}, [&](const TIntEvent&) { Order.push_back(2); });
+    Sys.Subscribe<TIntEvent>(5, [&](const TIntEvent&) { Order.push_back(3); });
+    Sys.Subscribe<TIntEvent>(TEventSystem::Priority::Normal, [&](const TIntEvent&) { Order.push_back(4); });
+    Sys.Subscribe<TIntEvent>(5, [&](const TIntEvent&) { Order.push_back(5); });
+    Sys.Subscribe<TIntEvent>(std::int16_t{-30000}, [&](const TIntEvent&) { Order.push_back(7); });
+    Sys.Subscribe<TIntEvent>(TEventSystem::Priority::Low, [&](const TIntEvent&) { Order.push_back(6); });
+
+    Sys.Dispatch(TIntEvent{0});
+    EXPECT_EQ(Order, (std::vector<int>{1, 2, 3, 5, 4, 6, 7}));
+}
+
 TEST(EventSystemBasic, MultipleEventTypes) {
     TEventSystem Sys;
     bool IntCalled = false;
@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include "event_system/SocketBridge.hpp"
+
+using namespace NEventSystem;
+
+namespace {
+
+    struct TSocketPair {
+        int Fds[2] = {-1, -1};
+
+        TSocketPair() {
+            EXPECT_EQ(::socketpair(AF_UNIX, SOCK_SEQPACKET, 0, Fds), 0);
+        }
+
+        ~TSocketPair() {
+            ::close(Fds[0]);
+            ::close(Fds[1]);
+        }
+    };
+
+} // namespace
+
+struct TBridgeMoveEvent {
+    int EntityId;
+    float X;
+};
+
+struct TBridgeHitEvent {
+    int Damage;
+};
+
+TEST(SocketBridge, ForwardsEventsInOrder) {
+    TSocketPair Pair;
+    TEventSystem Source;
+    TEventSystem Sink;
+
+    TSocketBridgeSender Sender(Source, Pair.Fds[0]);
+    Sender.Forward<TBridgeMoveEvent>(1);
+    Sender.Forward<TBridgeHitEvent>(2);
+
+    TSocketBridgeReceiver Receiver(Sink, Pair.Fds[1]);
+    Receiver.Route<TBridgeMoveEvent>(1);
+    Receiver.Route<TBridgeHitEvent>(2);
+
+    std::vector<int> Log;
+    Sink.Subscribe<TBridgeMoveEvent>(TEventSystem::Priority::Normal, [&](const TBridgeMoveEvent& e) {
+        Log.push_back(e.EntityId);
+    });
+    Sink.Subscribe<TBridgeHitEvent>(TEventSystem::Priority::Normal, [&](const TBridgeHitEvent& e) {
+        Log.push_back(-e.Damage);
+    });
+
+    Source.Dispatch(TBridgeMoveEvent{1, 0.5f});
+    Source.Dispatch(TBridgeMoveEvent{2, 0.5f});
+    Source.Dispatch(TBridgeHitEvent{7});
+    Source.Dispatch(TBridgeMoveEvent{3, 0.5f});
+
+    // Всё ещё в кадре отправителя.
+    EXPECT_EQ(Sender.GetPendingFrames(), 1u);
+    EXPECT_EQ(Receiver.Receive(false), 0u);
+
+    Sender.Flush();
+    EXPECT_EQ(Receiver.Receive(), 4u);
+
+    EXPECT_EQ(Log, (std::vector<int>{1, 2, -7, 3}));
+}
+
+TEST(SocketBridge, ZeroMaxDelaySendsEachEvent) {
+    TSocketPair Pair;
+    TEventSystem Source;
+    TEventSystem Sink;
+
+    TSocketBridgeSender Sender(Source, Pair.Fds[0]);
+    Sender.Forward<TBridgeHitEvent>(2);
+    Sender.SetMaxDelay(std::chrono::nanoseconds::zero());
+
+    TSocketBridgeReceiver Receiver(Sink, Pair.Fds[1]);
+    Receiver.Route<TBridgeHitEvent>(2);
+
+    std::vector<int> Log;
+    Sink.Subscribe<TBridgeHitEvent>(TEventSystem::Priority::Normal, [&](const TBridgeHitEvent& e) {
+        Log.push_back(e.Damage);
+    });
+
+    Source.Dispatch(TBridgeHitEvent{5});
+    EXPECT_EQ(Sender.GetPendingFrames(), 0u);
+    EXPECT_EQ(Receiver.Receive(false), 1u);
+    EXPECT_EQ(Log, (std::vector<int>{5}));
+}
+
+TEST(SocketBridge, HandlerErrorKeepsReceivedFrames) {
+    TSocketPair Pair;
+    TEventSystem Source;
+    TEventSystem Sink;
+
+    TSocketBridgeSender Sender(Source, Pair.Fds[0]);
+    Sender.Forward<TBridgeMoveEvent>(1);
+    Sender.Forward<TBridgeHitEvent>(2);
+
+    TSocketBridgeReceiver Receiver(Sink, Pair.Fds[1]);
+    Receiver.Route<TBridgeMoveEvent>(1);
+    Receiver.Route<TBridgeHitEvent>(2);
+
+    std::vector<int> Log;
+    Sink.Subscribe<TBridgeMoveEvent>(TEventSystem::Priority::Normal, [&](const TBridgeMoveEvent& e) {
+        Log.push_back(e.EntityId);
+    });
+    Sink.Subscribe<TBridgeHitEvent>(TEventSystem::Priority::Normal, [](const TBridgeHitEvent&) {
+        throw std::runtime_error("hit");
+    });
+
+    Source.Dispatch(TBridgeMoveEvent{1, 0.0f});
+    Source.Dispatch(TBridgeHitEvent{7});
+    Source.Dispatch(TBridgeMoveEvent{2, 0.0f});
+    Sender.Flush();
+    Source.Dispatch(TBridgeMoveEvent{3, 0.0f});
+    Sender.Flush();
+
+    // Оба кадра вычитаны одним recvmmsg, разбор встал на Hit.
+    EXPECT_THROW(Receiver.Receive(), std::runtime_error);
+    EXPECT_EQ(Log, (std::vector<int>{1}));
+    EXPECT_EQ(Receiver.GetPendingFrames(), 2u);
+
+    EXPECT_EQ(Receiver.Receive(false), 2u);
+    EXPECT_EQ(Receiver.GetPendingFrames(), 0u);
+    EXPECT_EQ(Log, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(SocketBridge, SplitsIntoFramesAndSkipsUnroutedTags) {
+    TSocketPair Pair;
+    TEventSystem Source;
+    TEventSystem Sink;
+
+    // Маленький кадр: по два события в кадре.
+    constexpr std::size_t KFrameBytes = 2 * (sizeof(NInternal::TBridgeRecordHeader) + sizeof(TBridgeMoveEvent));
+    TSocketBridgeSender Sender(Source, Pair.Fds[0], KFrameBytes);
+    Sender.Forward<TBridgeMoveEvent>(1);
+    Sender.Forward<TBridgeHitEvent>(2);
+
+    TSocketBridgeReceiver Receiver(Sink, Pair.Fds[1], KFrameBytes);
+    Receiver.Route<TBridgeMoveEvent>(1);
+
+    int Moves = 0;
+    Sink.Subscribe<TBridgeMoveEvent>(TEventSystem::Priority::Normal, [&](const auto&) {
+        ++Moves;
+    });
+
+    for (int i = 0; i < 5; ++i) {
+        Source.Dispatch(TBridgeMoveEvent{i, 0.0f});
+        Source.Dispatch(TBridgeHitEvent{i});
+    }
+    Sender.Flush();
+
+    std::size_t Delivered = 0;
+    while (Delivered < 5) {
+        Delivered += Receiver.Receive();
+    }
+
+    EXPECT_EQ(Moves, 5);
+    EXPECT_FALSE(Receiver.IsPeerClosed());
+}
+
+TEST(SocketBridge, PartialSendIsNotRepeated) {
+    TSocketPair Pair;
+    TEventSystem Source;
+    TEventSystem Sink;
+
+    // Неблокирующий сокет с маленьким буфером: sendmmsg отправит часть кадров и упрётся в EAGAIN.
+    const int SendBuffer = 4096;
+    ASSERT_EQ(::setsockopt(Pair.Fds[0], SOL_SOCKET, SO_SNDBUF, &SendBuffer, sizeof(SendBuffer)), 0);
+    ASSERT_EQ(::fcntl(Pair.Fds[0], F_SETFL, ::fcntl(Pair.Fds[0], F_GETFL) | O_NONBLOCK), 0);
+
+    constexpr std::size_t KFrameBytes = 64 * (sizeof(NInternal::TBridgeRecordHeader) + sizeof(TBridgeMoveEvent));
+    TSocketBridgeSender Sender(Source, Pair.Fds[0], KFrameBytes);
+    Sender.Forward<TBridgeMoveEvent>(1);
+
+    TSocketBridgeReceiver Receiver(Sink, Pair.Fds[1], KFrameBytes);
+    Receiver.Route<TBridgeMoveEvent>(1);
+
+    std::vector<int> Log;
+    Sink.Subscribe<TBridgeMoveEvent>(TEventSystem::Priority::Normal, [&](const TBridgeMoveEvent& e) {
+        Log.push_back(e.EntityId);
+    });
+
+    constexpr int KEvents = 64 * 16;
+    for (int i = 0; i < KEvents; ++i) {
+        Source.Dispatch(TBridgeMoveEvent{i, 0.0f});
+    }
+
+    bool Blocked = false;
+    for (;;) {
+        try {
+            Sender.Flush();
+            break;
+        } catch (const std::system_error& e) {
+            ASSERT_EQ(e.code().value(), EAGAIN);
+            Blocked = true;
+            while (Receiver.Receive(false) != 0) {
+            }
+        }
+    }
+    while (Receiver.Receive(false) != 0) {
+    }
+
+    EXPECT_TRUE(Blocked);
+    ASSERT_EQ(Log.size(), static_cast<std::size_t>(KEvents));
+    for (int i = 0; i < KEvents; ++i) {
+        EXPECT_EQ(Log[i], i);
+    }
+}
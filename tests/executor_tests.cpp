@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "event_system/EventSystem.hpp"
+
+using namespace NEventSystem;
+
+namespace {
+
+    /// Событие, которое считает свои копии и живые экземпляры.
+    struct TCountedEvent {
+        inline static std::atomic<int> Copies{0};
+        inline static std::atomic<int> Alive{0};
+
+        int Value;
+
+        explicit TCountedEvent(int value)
+            : Value(value) {
+            ++Alive;
+        }
+
+        TCountedEvent(const TCountedEvent& other)
+            : Value(other.Value) {
+            ++Copies;
+            ++Alive;
+        }
+
+        ~TCountedEvent() {
+            --Alive;
+        }
+    };
+
+} // namespace
+
+TEST(Executor, AsyncHandlersRunOnDrainingThread) {
+    TEventSystem Sys;
+    TExecutor Executor;
+
+    std::vector<int> Log;
+    Sys.SubscribeOn<TCountedEvent>(Executor, TEventSystem::Priority::Normal, [&](const TCountedEvent& e) {
+        Log.push_back(e.Value);
+    });
+
+    Sys.Dispatch(TCountedEvent{1});
+    Sys.Dispatch(TCountedEvent{2});
+    EXPECT_TRUE(Log.empty());
+    EXPECT_EQ(Executor.GetQueueSize(), 2u);
+
+    EXPECT_EQ(Executor.DrainReady(), 2u);
+    EXPECT_EQ(Log, (std::vector<int>{1, 2}));
+}
+
+TEST(Executor, FanOutCopiesEventOnceAndFreesAfterLastHandler) {
+    TEventSystem Sys;
+    TExecutor First;
+    TExecutor Second;
+
+    int FirstCalls = 0;
+    int SecondCalls = 0;
+    int InlineCalls = 0;
+    Sys.SubscribeOn<TCountedEvent>(First, TEventSystem::Priority::Normal, [&](const auto&) {
+        ++FirstCalls;
+    });
+    Sys.SubscribeOn<TCountedEvent>(First, TEventSystem::Priority::Low, [&](const auto&) {
+        ++FirstCalls;
+    });
+    Sys.SubscribeOn<TCountedEvent>(Second, TEventSystem::Priority::Normal, [&](const auto&) {
+        ++SecondCalls;
+    });
+    Sys.Subscribe<TCountedEvent>(TEventSystem::Priority::Normal, [&](const auto&) {
+        ++InlineCalls;
+    });
+
+    TCountedEvent::Copies = 0;
+    const int AliveBefore = TCountedEvent::Alive.load();
+    {
+        const TCountedEvent Event{7};
+        Sys.Dispatch(Event);
+    }
+
+    EXPECT_EQ(InlineCalls, 1);
+    EXPECT_EQ(TCountedEvent::Copies, 1);
+    EXPECT_EQ(TCountedEvent::Alive, AliveBefore + 1);
+
+    First.DrainReady();
+    EXPECT_EQ(FirstCalls, 2);
+    EXPECT_EQ(TCountedEvent::Alive, AliveBefore + 1);
+
+    Second.DrainReady();
+    EXPECT_EQ(SecondCalls, 1);
+    EXPECT_EQ(TCountedEvent::Alive, AliveBefore);
+}
+
+TEST(Executor, UnsubscribedAsyncHandlerIsSkipped) {
+    TEventSystem Sys;
+    TExecutor Executor;
+
+    int Calls = 0;
+    auto Id = Sys.SubscribeOn<TCountedEvent>(Executor, TEventSystem::Priority::Normal, [&](const auto&) {
+        ++Calls;
+    });
+
+    Sys.Dispatch(TCountedEvent{1});
+    Sys.Unsubscribe(Id);
+    Executor.DrainReady();
+    EXPECT_EQ(Calls, 0);
+
+    Sys.Dispatch(TCountedEvent{2});
+    EXPECT_EQ(Executor.GetQueueSize(), 0u);
+}
+
+TEST(Executor, OutlivesEventSystemAndDropsPendingDeliveries) {
+    TExecutor Executor;
+    const int AliveBefore = TCountedEvent::Alive.load();
+
+    int Calls = 0;
+    {
+        TEventSystem Sys;
+        Sys.SubscribeOn<TCountedEvent>(Executor, TEventSystem::Priority::Normal, [&](const auto&) {
+            ++Calls;
+        });
+        Sys.Dispatch(TCountedEvent{1});
+        Sys.Dispatch(TCountedEvent{2});
+    }
+
+    // Блоки держат диспетчер с пулом; подписки уже сняты.
+    EXPECT_EQ(TCountedEvent::Alive, AliveBefore + 2);
+    EXPECT_EQ(Executor.DrainReady(), 2u);
+    EXPECT_EQ(Calls, 0);
+    EXPECT_EQ(TCountedEvent::Alive, AliveBefore);
+}
+
+TEST(Executor, WorkerThreadWaitsForEvents) {
+    TEventSystem Sys;
+    TExecutor Executor;
+
+    constexpr int KEvents = 500;
+    std::atomic<int> Calls{0};
+    Sys.SubscribeOn<TCountedEvent>(Executor, TEventSystem::Priority::Normal, [&](const auto&) {
+        Calls.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    std::thread Worker([&] {
+        while (Executor.WaitAndDrain() != 0) {
+        }
+    });
+
+    for (int i = 0; i < KEvents; ++i) {
+        Sys.Dispatch(TCountedEvent{i});
+    }
+
+    while (Calls.load(std::memory_order_relaxed) < KEvents) {
+        std::this_thread::yield();
+    }
+    Executor.Interrupt();
+    Worker.join();
+
+    EXPECT_EQ(Calls.load(), KEvents);
+}
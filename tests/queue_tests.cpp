@@ -0,0 +1,540 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+    #include <poll.h>
+    #include <unistd.h>
+#endif
+
+#include "event_system/EventSystem.hpp"
+
+using namespace NEventSystem;
+
+namespace {
+
+#if defined(__linux__)
+    bool IsReadable(int Fd) {
+        pollfd Pfd{Fd, POLLIN, 0};
+        return ::poll(&Pfd, 1, 0) == 1 && (Pfd.revents & POLLIN);
+    }
+#endif
+
+    struct TSignalEvent {
+        int Signal;
+    };
+
+    TEventSystem* SignalSystem = nullptr;
+
+    extern "C" void EnqueueSignal(int Signal) {
+        SignalSystem->TrySignalEnqueue(TSignalEvent{Signal});
+    }
+
+} // namespace
+
+struct TQueuedEvent {
+    int Value;
+};
+
+struct TOtherQueuedEvent {
+    int Value;
+};
+
+TEST(EventQueue, EnqueueDefersUntilDrain) {
+    TEventSystem Sys;
+    std::vector<int> Log;
+
+    Sys.Subscribe<TQueuedEvent>(TEventSystem::Priority::Normal, [&](const TQueuedEvent& e) {
+        Log.push_back(e.Value);
+    });
+    Sys.Subscribe<TOtherQueuedEvent>(TEventSystem::Priority::Normal, [&](const TOtherQueuedEvent& e) {
+        Log.push_back(-e.Value);
+    });
+
+    Sys.Enqueue(TQueuedEvent{1});
+    Sys.Enqueue(TOtherQueuedEvent{2});
+    Sys.Enqueue(TQueuedEvent{3});
+
+    EXPECT_TRUE(Log.empty());
+    EXPECT_EQ(Sys.GetQueueSize(), 3u);
+
+    EXPECT_EQ(Sys.DrainReady(2), 2u);
+    EXPECT_EQ(Log, (std::vector<int>{1, -2}));
+
+    EXPECT_EQ(Sys.DrainReady(), 1u);
+    EXPECT_EQ(Log, (std::vector<int>{1, -2, 3}));
+    EXPECT_EQ(Sys.GetQueueSize(), 0u);
+}
+
+TEST(EventQueue, ThrowingHandlerKeepsRestOfBatchQueued) {
+    TEventSystem Sys;
+    std::vector<int> Log;
+
+    Sys.Subscribe<TQueuedEvent>(TEventSystem::Priority::Normal, [&](const TQueuedEvent& e) {
+        if (e.Value == 2) {
+            throw std::runtime_error("boom");
+        }
+        Log.push_back(e.Value);
+    });
+
+    for (int i = 1; i <= 4; ++i) {
+        Sys.Enqueue(TQueuedEvent{i});
+    }
+
+    EXPECT_THROW(Sys.DrainReady(), std::runtime_error);
+    EXPECT_EQ(Sys.GetQueueSize(), 2u);
+
+    EXPECT_EQ(Sys.DrainReady(), 2u);
+    EXPECT_EQ(Log, (std::vector<int>{1, 3, 4}));
+}
+
+TEST(EventQueue, GroupedDrainKeepsPerTypeOrder) {
+    TEventSystem Sys;
+    std::vector<int> Log;
+
+    Sys.Subscribe<TQueuedEvent>(TEventSystem::Priority::Normal, [&](const TQueuedEvent& e) {
+        Log.push_back(e.Value);
+    });
+    Sys.Subscribe<TOtherQueuedEvent>(TEventSystem::Priority::Normal, [&](const TOtherQueuedEvent& e) {
+        Log.push_back(-e.Value);
+    });
+
+    for (int i = 1; i <= 3; ++i) {
+        Sys.Enqueue(TQueuedEvent{i});
+        Sys.Enqueue(TOtherQueuedEvent{i});
+    }
+
+    EXPECT_EQ(Sys.DrainReady(std::numeric_limits<std::size_t>::max(), EDrainOrder::GroupByType), 6u);
+
+    // Порядок групп зависит от id типов, порядок внутри типа — FIFO.
+    const std::vector<int> Positive{1, 2, 3};
+    const std::vector<int> Negative{-1, -2, -3};
+    ASSERT_EQ(Log.size(), 6u);
+    const std::vector<int> Head(Log.begin(), Log.begin() + 3);
+    const std::vector<int> Tail(Log.begin() + 3, Log.end());
+    EXPECT_TRUE((Head == Positive && Tail == Negative) || (Head == Negative && Tail == Positive));
+}
+
+TEST(EventQueue, PriorityLanesAreWeightedAcrossTypes) {
+    TEventSystem Sys;
+    std::vector<int> Log;
+
+    Sys.Subscribe<TQueuedEvent>(TEventSystem::Priority::Normal, [&](const TQueuedEvent& e) {
+        Log.push_back(e.Value);
+    });
+    Sys.Subscribe<TOtherQueuedEvent>(TEventSystem::Priority::Normal, [&](const TOtherQueuedEvent& e) {
+        Log.push_back(-e.Value);
+    });
+
+    EXPECT_THROW(Sys.SetQueueWeights({1, 0, 1}), std::invalid_argument);
+    Sys.SetQueueWeights({2, 1, 1});
+
+    for (int i = 1; i <= 3; ++i) {
+        Sys.Enqueue(TEventSystem::Priority::Low, TOtherQueuedEvent{i});
+    }
+    for (int i = 10; i <= 15; ++i) {
+        Sys.Enqueue(TEventSystem::Priority::High, TQueuedEvent{i});
+    }
+    Sys.Enqueue(TQueuedEvent{20});
+
+    // Круг — два High, один Normal, один Low; Low не ждёт, пока кончатся High.
+    EXPECT_EQ(Sys.DrainReady(), 10u);
+    EXPECT_EQ(Log, (std::vector<int>{10, 11, 20, -1, 12, 13, -2, 14, 15, -3}));
+
+    // Круг не сбрасывается между вызовами DrainReady: High свою долю
+    // в текущем круге уже выбрал, так что следующим идёт Low.
+    Log.clear();
+    for (int i = 1; i <= 2; ++i) {
+        Sys.Enqueue(TEventSystem::Priority::Low, TOtherQueuedEvent{i});
+    }
+    for (int i = 10; i <= 13; ++i) {
+        Sys.Enqueue(TEventSystem::Priority::High, TQueuedEvent{i});
+    }
+    while (Sys.DrainReady(1) != 0) {
+    }
+    EXPECT_EQ(Log, (std::vector<int>{-1, 10, 11, -2, 12, 13}));
+}
+
+TEST(EventQueue, RawPrioritiesPickLaneByRange) {
+    TEventSystem Sys;
+    std::vector<int> Log;
+
+    Sys.Subscribe<TQueuedEvent>(TEventSystem::Priority::Normal, [&](const TQueuedEvent& e) {
+        Log.push_back(e.Value);
+    });
+    Sys.SetQueueWeights({2, 1, 1});
+
+    // 1 и -300 лежат в диапазоне Normal, 600 — в High, -600 — в Low:
+    // Normal получает свою долю круга, а не ждёт, пока опустеет High.
+    for (int i = 10; i <= 13; ++i) {
+        Sys.Enqueue(TEventSystem::Priority::High, TQueuedEvent{i});
+    }
+    Sys.Enqueue(TEventSystem::PriorityValue(std::int16_t{600}), TQueuedEvent{14});
+    Sys.Enqueue(TEventSystem::PriorityValue(std::int16_t{1}), TQueuedEvent{20});
+    Sys.Enqueue(TEventSystem::PriorityValue(std::int16_t{-300}), TQueuedEvent{21});
+    Sys.Enqueue(TEventSystem::PriorityValue(std::int16_t{-600}), TQueuedEvent{30});
+
+    EXPECT_EQ(Sys.DrainReady(), 8u);
+    EXPECT_EQ(Log, (std::vector<int>{10, 11, 20, 30, 12, 13, 21, 14}));
+}
+
+TEST(EventQueue, DeadlineEventsRunEarliestFirstAndExpire) {
+    using namespace std::chrono_literals;
+    TEventSystem Sys;
+    std::vector<int> Log;
+
+    Sys.Subscribe<TQueuedEvent>(TEventSystem::Priority::Normal, [&](const TQueuedEvent& e) {
+        Log.push_back(e.Value);
+    });
+    Sys.Subscribe<TExpired<TQueuedEvent>>(TEventSystem::Priority::Normal, [&](const TExpired<TQueuedEvent>& e) {
+        Log.push_back(-e.Event.Value);
+    });
+
+    const auto Now = std::chrono::steady_clock::now();
+    Sys.Enqueue(TEventSystem::Priority::High, TQueuedEvent{100});
+    Sys.EnqueueWithDeadline(TQueuedEvent{3}, Now + 30s);
+    Sys.EnqueueWithDeadline(TQueuedEvent{1}, Now + 10s);
+    Sys.EnqueueWithDeadline(TQueuedEvent{4}, Now + 1h);
+    Sys.EnqueueWithDeadline(TQueuedEvent{2}, Now + 10s);
+    Sys.EnqueueWithDeadline(TQueuedEvent{5}, Now - 1s);
+    Sys.EnqueueWithDeadline(TQueuedEvent{6}, Now - 2s, EExpiredPolicy::Redirect);
+    EXPECT_EQ(Sys.GetQueueSize(), 7u);
+
+    // Просроченные не занимают место в пакете, но попадают в счёт.
+    EXPECT_EQ(Sys.DrainReady(2), 4u);
+    EXPECT_EQ(Log, (std::vector<int>{-6, 1, 2}));
+
+    EXPECT_EQ(Sys.DrainReady(), 3u);
+    EXPECT_EQ(Log, (std::vector<int>{-6, 1, 2, 3, 4, 100}));
+    EXPECT_EQ(Sys.GetQueueSize(), 0u);
+}
+
+TEST(EventQueue, DeadlinesShareRoundWithLanes) {
+    using namespace std::chrono_literals;
+    TEventSystem Sys;
+    std::vector<int> Log;
+
+    Sys.Subscribe<TQueuedEvent>(TEventSystem::Priority::Normal, [&](const TQueuedEvent& e) {
+        Log.push_back(e.Value);
+    });
+    EXPECT_THROW(Sys.SetQueueWeights({1, 1, 1, 0}), std::invalid_argument);
+    Sys.SetQueueWeights({2, 1, 1, 2});
+
+    // Поток событий с дедлайном не вытесняет High: у очереди дедлайнов
+    // своя доля круга, и она идёт в нём первой.
+    const auto Now = std::chrono::steady_clock::now();
+    for (int i = 1; i <= 6; ++i) {
+        Sys.EnqueueWithDeadline(TQueuedEvent{i}, Now + 10s + std::chrono::milliseconds(i));
+    }
+    for (int i = 10; i <= 13; ++i) {
+        Sys.Enqueue(TEventSystem::Priority::High, TQueuedEvent{i});
+    }
+
+    EXPECT_EQ(Sys.DrainReady(), 10u);
+    EXPECT_EQ(Log, (std::vector<int>{1, 2, 10, 11, 3, 4, 12, 13, 5, 6}));
+}
+
+TEST(EventQueue, LateDeadlinesKeepOrderInCurrentBucket) {
+    using namespace std::chrono_literals;
+    TEventSystem Sys;
+    std::vector<int> Log;
+
+    Sys.Subscribe<TQueuedEvent>(TEventSystem::Priority::Normal, [&](const TQueuedEvent& e) {
+        Log.push_back(e.Value);
+    });
+
+    // Все дедлайны в одной корзине: после первой выборки она уже
+    // отсортирована, и опоздавшие встают на место, не ломая порядок.
+    const auto Base = std::chrono::floor<std::chrono::milliseconds>(std::chrono::steady_clock::now()) + 10s;
+    Sys.EnqueueWithDeadline(TQueuedEvent{1}, Base + 500us);
+    Sys.EnqueueWithDeadline(TQueuedEvent{2}, Base + 800us);
+    EXPECT_EQ(Sys.DrainReady(1), 1u);
+
+    Sys.EnqueueWithDeadline(TQueuedEvent{3}, Base + 100us);
+    Sys.EnqueueWithDeadline(TQueuedEvent{4}, Base + 800us);
+    Sys.EnqueueWithDeadline(TQueuedEvent{5}, Base + 900us);
+    EXPECT_EQ(Sys.DrainReady(), 4u);
+    EXPECT_EQ(Log, (std::vector<int>{1, 3, 2, 4, 5}));
+}
+
+TEST(EventQueue, BudgetDeferralKeepsLaneShare) {
+    using namespace std::chrono_literals;
+    TEventSystem Sys;
+    std::vector<int> Log;
+
+    Sys.Subscribe<TQueuedEvent>(TEventSystem::Priority::Normal, [&](const TQueuedEvent& e) {
+        std::this_thread::sleep_for(50ms);
+        Log.push_back(e.Value);
+    });
+    Sys.Subscribe<TOtherQueuedEvent>(TEventSystem::Priority::Normal, [&](const TOtherQueuedEvent& e) {
+        Log.push_back(-e.Value);
+    });
+    Sys.SetQueueWeights({1, 1, 1});
+
+    for (int i = 1; i <= 2; ++i) {
+        Sys.Enqueue(TEventSystem::Priority::High, TQueuedEvent{i});
+        Sys.Enqueue(TEventSystem::Priority::Low, TOtherQueuedEvent{i});
+    }
+
+    // Второе дорогое High-событие не помещается в остаток бюджета и
+    // откладывается; его полоса сохраняет долю и идёт следующей.
+    const auto Report = Sys.ProcessQueueFor(80ms);
+    EXPECT_EQ(Report.Processed, 2u);
+    EXPECT_EQ(Report.Deferred, 2u);
+    EXPECT_EQ(Log, (std::vector<int>{1, -1}));
+
+    EXPECT_EQ(Sys.DrainReady(1), 1u);
+    EXPECT_EQ(Log, (std::vector<int>{1, -1, 2}));
+}
+
+TEST(EventQueue, ProcessQueueForStopsAtBudget) {
+    using namespace std::chrono_literals;
+    TEventSystem Sys;
+    std::vector<int> Log;
+
+    Sys.Subscribe<TQueuedEvent>(TEventSystem::Priority::Normal, [&](const TQueuedEvent& e) {
+        Log.push_back(e.Value);
+    });
+    Sys.Subscribe<TOtherQueuedEvent>(TEventSystem::Priority::Normal, [&](const TOtherQueuedEvent& e) {
+        std::this_thread::sleep_for(5ms);
+        Log.push_back(-e.Value);
+    });
+
+    // Первый вызов узнаёт стоимость медленного типа.
+    Sys.Enqueue(TOtherQueuedEvent{1});
+    auto Report = Sys.ProcessQueueFor(1us);
+    EXPECT_EQ(Report.Processed, 1u);
+    EXPECT_EQ(Report.Deferred, 0u);
+    EXPECT_GE(Report.Elapsed, 5ms);
+
+    Sys.Enqueue(TEventSystem::Priority::High, TQueuedEvent{1});
+    Sys.Enqueue(TOtherQueuedEvent{2});
+    Sys.Enqueue(TOtherQueuedEvent{3});
+
+    // Быстрое событие укладывается, медленное уже не влезает в бюджет.
+    Report = Sys.ProcessQueueFor(2ms);
+    EXPECT_EQ(Report.Processed, 1u);
+    EXPECT_EQ(Report.Deferred, 2u);
+    EXPECT_EQ(Log, (std::vector<int>{-1, 1}));
+
+    Report = Sys.ProcessQueueFor(1s);
+    EXPECT_EQ(Report.Processed, 2u);
+    EXPECT_EQ(Report.Deferred, 0u);
+    EXPECT_EQ(Log, (std::vector<int>{-1, 1, -2, -3}));
+
+    // Просроченное не засчитывается за доставленное: медленное всё равно идёт.
+    Sys.EnqueueWithDeadline(TQueuedEvent{4}, std::chrono::steady_clock::now() - 1s);
+    Sys.Enqueue(TOtherQueuedEvent{5});
+    Report = Sys.ProcessQueueFor(1us);
+    EXPECT_EQ(Report.Processed, 2u);
+    EXPECT_EQ(Report.Deferred, 0u);
+    EXPECT_EQ(Log, (std::vector<int>{-1, 1, -2, -3, -5}));
+}
+
+TEST(EventQueue, GroupedDrainRequeuesRemainderWhenHandlerThrows) {
+    TEventSystem Sys;
+    std::vector<int> Log;
+
+    Sys.Subscribe<TQueuedEvent>(TEventSystem::Priority::Normal, [&](const TQueuedEvent& e) {
+        if (e.Value == 2) {
+            throw std::runtime_error("boom");
+        }
+        Log.push_back(e.Value);
+    });
+    Sys.Subscribe<TOtherQueuedEvent>(TEventSystem::Priority::Normal, [&](const TOtherQueuedEvent& e) {
+        Log.push_back(-e.Value);
+    });
+
+    Sys.Enqueue(TQueuedEvent{1});
+    Sys.Enqueue(TOtherQueuedEvent{1});
+    Sys.Enqueue(TQueuedEvent{2});
+    Sys.Enqueue(TQueuedEvent{3});
+
+    EXPECT_THROW(Sys.DrainReady(std::numeric_limits<std::size_t>::max(), EDrainOrder::GroupByType),
+                 std::runtime_error);
+    // Остаток группы TQueuedEvent (и, возможно, следующая группа) вернулся в очередь.
+    const std::size_t Remaining = Sys.GetQueueSize();
+    EXPECT_GE(Remaining, 1u);
+    EXPECT_EQ(Sys.DrainReady(std::numeric_limits<std::size_t>::max(), EDrainOrder::GroupByType), Remaining);
+    std::sort(Log.begin(), Log.end());
+    EXPECT_EQ(Log, (std::vector<int>{-1, 1, 3}));
+}
+
+#if defined(__linux__)
+TEST(EventQueue, WakeupFdSignalsOncePerTransition) {
+    TEventSystem Sys;
+    Sys.Subscribe<TQueuedEvent>(TEventSystem::Priority::Normal, [](const auto&) {});
+
+    const int Fd = Sys.GetQueueFd();
+    ASSERT_GE(Fd, 0);
+    EXPECT_FALSE(IsReadable(Fd));
+
+    Sys.Enqueue(TQueuedEvent{1});
+    Sys.Enqueue(TQueuedEvent{2});
+    Sys.Enqueue(TQueuedEvent{3});
+    EXPECT_TRUE(IsReadable(Fd));
+
+    // Частичная выборка оставляет дескриптор читаемым.
+    Sys.DrainReady(1);
+    EXPECT_TRUE(IsReadable(Fd));
+
+    Sys.DrainReady();
+    EXPECT_FALSE(IsReadable(Fd));
+
+    // Выборка из пустой очереди дескриптор не трогает.
+    EXPECT_EQ(Sys.DrainReady(), 0u);
+    EXPECT_FALSE(IsReadable(Fd));
+
+    // Три постановки дали одну запись в eventfd.
+    Sys.Enqueue(TQueuedEvent{4});
+    Sys.Enqueue(TQueuedEvent{5});
+    std::uint64_t Counter = 0;
+    ASSERT_EQ(::read(Fd, &Counter, sizeof(Counter)), static_cast<ssize_t>(sizeof(Counter)));
+    EXPECT_EQ(Counter, 1u);
+}
+#endif
+
+TEST(EventQueue, SignalEnqueueDeliversOnDrain) {
+    TEventSystem Sys;
+    std::vector<int> Log;
+
+    Sys.Subscribe<TSignalEvent>(TEventSystem::Priority::Normal, [&](const TSignalEvent& e) {
+        Log.push_back(e.Signal);
+    });
+
+    // Без резервирования событие не принимается.
+    EXPECT_FALSE(Sys.TrySignalEnqueue(TSignalEvent{0}));
+
+    Sys.ReserveSignalQueue<TSignalEvent>(4);
+    SignalSystem = &Sys;
+    auto Previous = std::signal(SIGUSR1, EnqueueSignal);
+
+    std::raise(SIGUSR1);
+    std::raise(SIGUSR1);
+
+    std::signal(SIGUSR1, Previous);
+    SignalSystem = nullptr;
+
+    EXPECT_TRUE(Log.empty());
+    EXPECT_EQ(Sys.DrainSignalQueues(), 2u);
+    EXPECT_EQ(Log, (std::vector<int>{SIGUSR1, SIGUSR1}));
+}
+
+#if defined(__linux__)
+TEST(EventQueue, SignalEnqueueWakesQueueFd) {
+    TEventSystem Sys;
+    std::vector<int> Log;
+
+    Sys.Subscribe<TSignalEvent>(TEventSystem::Priority::Normal, [&](const TSignalEvent& e) {
+        Log.push_back(e.Signal);
+    });
+    Sys.Subscribe<TQueuedEvent>(TEventSystem::Priority::Normal, [&](const TQueuedEvent& e) {
+        Log.push_back(e.Value);
+    });
+    Sys.ReserveSignalQueue<TSignalEvent>(4);
+
+    const int Fd = Sys.GetQueueFd();
+    ASSERT_GE(Fd, 0);
+    EXPECT_FALSE(IsReadable(Fd));
+
+    // Две постановки из сигнального пути — одна запись в eventfd.
+    EXPECT_TRUE(Sys.TrySignalEnqueue(TSignalEvent{1}));
+    EXPECT_TRUE(Sys.TrySignalEnqueue(TSignalEvent{2}));
+    EXPECT_TRUE(IsReadable(Fd));
+
+    // DrainReady разбирает и сигнальные очереди, и обычную.
+    Sys.Enqueue(TQueuedEvent{10});
+    EXPECT_EQ(Sys.DrainReady(), 3u);
+    EXPECT_EQ(Log, (std::vector<int>{1, 2, 10}));
+    EXPECT_FALSE(IsReadable(Fd));
+
+    // ProcessQueueFor тоже разбирает сигнальные очереди.
+    Sys.Enqueue(TQueuedEvent{11});
+    EXPECT_TRUE(Sys.TrySignalEnqueue(TSignalEvent{3}));
+    EXPECT_EQ(Sys.ProcessQueueFor(std::chrono::seconds(1)).Processed, 2u);
+    EXPECT_FALSE(IsReadable(Fd));
+    EXPECT_EQ(Log, (std::vector<int>{1, 2, 10, 3, 11}));
+
+    // Сигнал, пришедший во время выборки, уже опустошившей очередь,
+    // оставляет дескриптор читаемым до следующего разбора.
+    Sys.Subscribe<TOtherQueuedEvent>(TEventSystem::Priority::Normal, [&](const TOtherQueuedEvent& e) {
+        Sys.TrySignalEnqueue(TSignalEvent{e.Value});
+    });
+    Sys.Enqueue(TOtherQueuedEvent{4});
+    EXPECT_EQ(Sys.DrainReady(), 1u);
+    EXPECT_TRUE(IsReadable(Fd));
+    EXPECT_EQ(Sys.DrainReady(), 1u);
+    EXPECT_FALSE(IsReadable(Fd));
+    EXPECT_EQ(Log.back(), 4);
+}
+#endif
+
+TEST(EventQueue, SignalQueueIsBounded) {
+    TEventSystem Sys;
+    int Calls = 0;
+    Sys.Subscribe<TSignalEvent>(TEventSystem::Priority::Normal, [&](const auto&) {
+        ++Calls;
+    });
+
+    Sys.ReserveSignalQueue<TSignalEvent>(4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(Sys.TrySignalEnqueue(TSignalEvent{i}));
+    }
+    EXPECT_FALSE(Sys.TrySignalEnqueue(TSignalEvent{4}));
+
+    EXPECT_EQ(Sys.DrainSignalQueues(), 4u);
+    EXPECT_EQ(Calls, 4);
+    EXPECT_TRUE(Sys.TrySignalEnqueue(TSignalEvent{5}));
+}
+
+class EventQueueWaitStrategy: public ::testing::TestWithParam<EWaitStrategy> {};
+
+TEST_P(EventQueueWaitStrategy, BlockingConsumerReceivesAllEvents) {
+    TEventSystem Sys;
+    Sys.SetWaitStrategy(GetParam());
+
+    constexpr int KEvents = 1000;
+    int Sum = 0;
+    Sys.Subscribe<TQueuedEvent>(TEventSystem::Priority::Normal, [&](const TQueuedEvent& e) {
+        Sum += e.Value;
+    });
+
+    std::thread Consumer([&] {
+        std::size_t Delivered = 0;
+        while (Delivered < KEvents) {
+            Delivered += Sys.WaitAndDrain(64);
+        }
+    });
+
+    for (int i = 1; i <= KEvents; ++i) {
+        Sys.Enqueue(TQueuedEvent{i});
+    }
+    Consumer.join();
+
+    EXPECT_EQ(Sum, KEvents * (KEvents + 1) / 2);
+}
+
+TEST_P(EventQueueWaitStrategy, InterruptWakesIdleConsumer) {
+    TEventSystem Sys;
+    Sys.SetWaitStrategy(GetParam());
+
+    std::thread Consumer([&] {
+        EXPECT_EQ(Sys.WaitAndDrain(), 0u);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    Sys.InterruptWait();
+    Consumer.join();
+}
+
+INSTANTIATE_TEST_SUITE_P(AllStrategies, EventQueueWaitStrategy,
+                         ::testing::Values(EWaitStrategy::BusySpin,
+                                           EWaitStrategy::SpinThenYield,
+                                           EWaitStrategy::Park));
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "event_system/TickScheduler.hpp"
+
+using namespace NEventSystem;
+using namespace std::chrono_literals;
+
+namespace {
+
+    struct TPhysicsTickEvent {
+        float DeltaTime;
+    };
+
+} // namespace
+
+TEST(TickScheduler, AccumulatesFixedSteps) {
+    TEventSystem Sys;
+    std::vector<float> Deltas;
+    Sys.Subscribe<TPhysicsTickEvent>(TEventSystem::Priority::Normal, [&](const TPhysicsTickEvent& e) {
+        Deltas.push_back(e.DeltaTime);
+    });
+
+    TFixedTickScheduler<TPhysicsTickEvent> Scheduler(Sys, 10ms);
+
+    auto Report = Scheduler.Advance(4ms);
+    EXPECT_EQ(Report.Ticks, 0u);
+    EXPECT_NEAR(Report.Alpha, 0.4, 1e-9);
+
+    Report = Scheduler.Advance(27ms);
+    EXPECT_EQ(Report.Ticks, 3u);
+    EXPECT_EQ(Report.Dropped, 0u);
+    EXPECT_NEAR(Report.Alpha, 0.1, 1e-9);
+
+    ASSERT_EQ(Deltas.size(), 3u);
+    for (const float Dt : Deltas) {
+        EXPECT_FLOAT_EQ(Dt, 0.01f);
+    }
+    EXPECT_EQ(Scheduler.GetTotalTicks(), 3u);
+}
+
+TEST(TickScheduler, CatchUpIsLimitedAndOverrunReported) {
+    TEventSystem Sys;
+    int Ticks = 0;
+    Sys.Subscribe<TPhysicsTickEvent>(TEventSystem::Priority::Normal, [&](const TPhysicsTickEvent&) {
+        ++Ticks;
+        std::this_thread::sleep_for(2ms);
+    });
+
+    TFixedTickScheduler<TPhysicsTickEvent> Scheduler(Sys, 1ms, 4, TPhysicsTickEvent{0.001f});
+
+    const auto Report = Scheduler.Advance(10500us);
+    EXPECT_EQ(Report.Ticks, 4u);
+    EXPECT_EQ(Report.Dropped, 6u);
+    EXPECT_NEAR(Report.Alpha, 0.5, 1e-9);
+    EXPECT_TRUE(Report.Overrun);
+    EXPECT_GE(Report.HandlerTime, 8ms);
+    EXPECT_EQ(Ticks, 4);
+    EXPECT_EQ(Scheduler.GetOverruns(), 1u);
+    EXPECT_EQ(Scheduler.GetTotalDropped(), 6u);
+
+    EXPECT_THROW(TFixedTickScheduler<TPhysicsTickEvent>(Sys, 0ms), std::invalid_argument);
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "event_system/VariantEventBus.hpp"
+
+using namespace NEventSystem;
+
+namespace {
+
+    struct TKeyEvent {
+        int Key;
+    };
+
+    struct TMoveEvent {
+        float X;
+        float Y;
+    };
+
+    struct TTextEvent {
+        std::string Text;
+    };
+
+    using TBus = TVariantEventBus<std::variant<TKeyEvent, TMoveEvent, TTextEvent>>;
+
+    static_assert(TBus::IndexOf<TMoveEvent>() == 1);
+    static_assert(!TBus::IsAlternative<int>);
+
+} // namespace
+
+TEST(VariantEventBus, JumpTableRoutesToAlternativeHandlersByPriority) {
+    TBus Bus;
+    std::vector<std::string> Log;
+
+    Bus.Subscribe<TKeyEvent>(TBus::Priority::Low, [&](const TKeyEvent& e) {
+        Log.push_back("low:" + std::to_string(e.Key));
+    });
+    Bus.Subscribe<TKeyEvent>(TBus::Priority::High, [&](const TKeyEvent& e) {
+        Log.push_back("high:" + std::to_string(e.Key));
+    });
+    Bus.Subscribe<TTextEvent>(TBus::Priority::Normal, [&](const TTextEvent& e) {
+        Log.push_back("text:" + e.Text);
+    });
+
+    Bus.Dispatch(TKeyEvent{5});
+    Bus.Dispatch(TMoveEvent{1.0f, 2.0f});
+    Bus.Dispatch(TTextEvent{"hi"});
+
+    EXPECT_EQ(Log, (std::vector<std::string>{"high:5", "low:5", "text:hi"}));
+}
+
+TEST(VariantEventBus, DrainDeliversMixedStreamInOrder) {
+    TBus Bus;
+    std::vector<std::string> Log;
+
+    Bus.Subscribe<TKeyEvent>(TBus::Priority::Normal, [&](const TKeyEvent& e) {
+        Log.push_back("key:" + std::to_string(e.Key));
+    });
+    Bus.Subscribe<TMoveEvent>(TBus::Priority::Normal, [&](const TMoveEvent& e) {
+        Log.push_back("move:" + std::to_string(static_cast<int>(e.X)));
+    });
+    Bus.Subscribe<TTextEvent>(TBus::Priority::Normal, [&](const TTextEvent& e) {
+        Log.push_back("text:" + e.Text);
+    });
+
+    Bus.Enqueue(TKeyEvent{1});
+    Bus.Enqueue(TTextEvent{"a"});
+    Bus.Enqueue(TMoveEvent{3.0f, 0.0f});
+    Bus.Enqueue(TBus::TEventVariant{TKeyEvent{2}});
+    EXPECT_EQ(Bus.GetQueueSize(), 4u);
+
+    EXPECT_EQ(Bus.DrainReady(), 4u);
+    EXPECT_EQ(Log, (std::vector<std::string>{"key:1", "text:a", "move:3", "key:2"}));
+    EXPECT_EQ(Bus.GetQueueSize(), 0u);
+}
+
+TEST(VariantEventBus, ThrowingHandlerKeepsRemainingEventsQueued) {
+    TBus Bus;
+    std::vector<int> Keys;
+
+    Bus.Subscribe<TKeyEvent>(TBus::Priority::Normal, [&](const TKeyEvent& e) {
+        if (e.Key == 2) {
+            throw std::runtime_error("boom");
+        }
+        Keys.push_back(e.Key);
+    });
+
+    Bus.Enqueue(TKeyEvent{1});
+    Bus.Enqueue(TKeyEvent{2});
+    Bus.Enqueue(TKeyEvent{3});
+
+    EXPECT_THROW(Bus.DrainReady(), std::runtime_error);
+    EXPECT_EQ(Bus.GetQueueSize(), 1u);
+    EXPECT_EQ(Bus.DrainReady(), 1u);
+    EXPECT_EQ(Keys, (std::vector<int>{1, 3}));
+}
+
+TEST(VariantEventBus, SubscriptionChangesDuringDispatchAreDeferred) {
+    TBus Bus;
+    int Added = 0;
+    int Removed = 0;
+    TBus::HandlerId RemovedId = 0;
+
+    Bus.Subscribe<TKeyEvent>(TBus::Priority::High, [&](const TKeyEvent&) {
+        Bus.Unsubscribe(RemovedId);
+        Bus.Subscribe<TKeyEvent>(TBus::Priority::Normal, [&](const TKeyEvent&) { ++Added; });
+    });
+    RemovedId = Bus.Subscribe<TKeyEvent>(TBus::Priority::Low, [&](const TKeyEvent&) { ++Removed; });
+
+    Bus.Dispatch(TKeyEvent{1});
+    EXPECT_EQ(Removed, 0);
+    EXPECT_EQ(Added, 0);
+    EXPECT_EQ(Bus.GetHandlerCount<TKeyEvent>(), 2u);
+
+    Bus.Dispatch(TKeyEvent{2});
+    EXPECT_EQ(Added, 1);
+    EXPECT_EQ(Bus.GetHandlerCount<TKeyEvent>(), 3u);
+}